@@ -35,6 +35,14 @@ int main()
             ankerl::nanobench::doNotOptimizeAway(book);
         });
 
+    ankerl::nanobench::Bench().minEpochIterations(100000).run(
+        "spb-pb-deserialize-trusted",
+        [&]
+        {
+            const auto book = spb::pb::deserialize<AddressBook>(buffer, {.trusted = true});
+            ankerl::nanobench::doNotOptimizeAway(book);
+        });
+
     ankerl::nanobench::Bench().minEpochIterations(100000).run("spb-json-serialize",
                                                               [&]
                                                               {
@@ -59,4 +67,22 @@ int main()
             const auto book = spb::json::deserialize<AddressBook>(buffer);
             ankerl::nanobench::doNotOptimizeAway(book);
         });
+
+    const auto scalars = spb::pb::serialize(init_scalars());
+
+    ankerl::nanobench::Bench().minEpochIterations(100000).run(
+        "spb-pb-deserialize-scalars",
+        [&]
+        {
+            const auto message = spb::pb::deserialize<Scalars>(scalars);
+            ankerl::nanobench::doNotOptimizeAway(message);
+        });
+
+    ankerl::nanobench::Bench().minEpochIterations(100000).run(
+        "spb-pb-deserialize-scalars-trusted",
+        [&]
+        {
+            const auto message = spb::pb::deserialize<Scalars>(scalars, {.trusted = true});
+            ankerl::nanobench::doNotOptimizeAway(message);
+        });
 }
@@ -15,3 +15,21 @@ auto init_message() -> AddressBook
                                        {.number = "6589652", .type = Person::PhoneType::PHONE_TYPE_HOME}}},
                        }};
 }
+
+auto init_scalars() -> Scalars
+{
+    return Scalars{.int32_value   = -587965,
+                   .int64_value   = 5879651234567,
+                   .uint32_value  = 4000000000,
+                   .uint64_value  = 18000000000000000000U,
+                   .sint32_value  = -89,
+                   .sint64_value  = -8945678912,
+                   .fixed32_value = 777888999,
+                   .fixed64_value = 456895251456895251,
+                   .bool_value    = true,
+                   .float_value   = 3.14F,
+                   .double_value  = 2.718281828,
+                   .string_value  = "hanz@obergartenmeister.at",
+                   .uint32_values = {1, 300, 70000, 20000000, 4000000000},
+                   .bool_values   = {true, false, true, true, false}};
+}
@@ -1,3 +1,5 @@
 #include <addressbook.pb.h>
+#include <scalar.pb.h>
 
 auto init_message() -> AddressBook;
+auto init_scalars() -> Scalars;
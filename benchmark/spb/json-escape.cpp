@@ -0,0 +1,34 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+#include "../nanobench.h"
+#include "common.h"
+#include <string>
+
+namespace
+{
+void run(const char *title, std::string_view text, const spb::json::serialize_options &options = {})
+{
+    auto name = std::string();
+    for (auto i = 0; i < 16; i++)
+        name += text;
+
+    const auto person = Person{.name = name};
+
+    std::string buffer;
+    ankerl::nanobench::Bench().minEpochIterations(100000).run(title,
+                                                              [&]
+                                                              {
+                                                                  auto size = spb::json::serialize(
+                                                                      person, buffer, options);
+                                                                  ankerl::nanobench::doNotOptimizeAway(size);
+                                                              });
+}
+} // namespace
+
+int main()
+{
+    run("spb-json-escape-ascii", "The quick brown fox jumps over the lazy dog. ");
+    run("spb-json-escape-heavy", "\"path\": \"C:\\\\tmp\\\\log.txt\"\n\tline\r\n");
+    run("spb-json-escape-non-ascii", "Příliš žluťoučký kůň úpěl ďábelské ódy. 日本語 ");
+    run("spb-json-escape-non-ascii-utf8", "Příliš žluťoučký kůň úpěl ďábelské ódy. 日本語 ",
+        {.escape_unicode = false});
+}
@@ -77,6 +77,17 @@ auto serialize_size(const auto &message, const serialize_options &options) -> si
  */
 auto serialize(const auto &message, void *buffer, const serialize_options &options) -> size_t;
 
+/**
+ * @brief serialize message as a list of chunks (scatter-gather), large `bytes` and `string`
+ *        fields are referenced in place instead of being copied
+ *
+ * @param[in] message to be serialized
+ * @param[out] builder chunks of the serialized message
+ * @param[in] options
+ * @return serialized size in bytes
+ */
+auto serialize_iov(const auto &message, iovec_builder &builder, const serialize_options &options) -> size_t;
+
 /**
  * @brief serialize message into protobuf
  *
@@ -140,6 +151,18 @@ auto deserialize(Message &message, const Container &protobuf, const deserialize_
 template <typename Message, spb::size_container Container>
 auto deserialize(const Container &protobuf, const deserialize_options &options) -> Message;
 
+/**
+ * @brief deserialize message from a chain of (non-contiguous) segments, without concatenating them
+ *
+ * @param[in] segments message split into segments (like a network buffer chain)
+ * @param[in] options
+ * @param[out] message deserialized message
+ * @return consumed size in bytes
+ * @throws std::runtime_error on error
+ */
+auto deserialize(auto &message, std::span<const std::span<const std::byte>> segments,
+                 const deserialize_options &options) -> size_t;
+
 /**
  * @brief deserialize message from reader
  *
@@ -158,16 +181,20 @@ void serialize_value(ostream_writer &, const ::ETL::Example::DeviceStatus &messa
 void serialize_value(ostream_buffer &, const ::ETL::Example::DeviceStatus &message);
 void deserialize_value(istream_reader &, ::ETL::Example::DeviceStatus &message, tag_type);
 void deserialize_value(istream_buffer &, ::ETL::Example::DeviceStatus &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::ETL::Example::DeviceStatus>);
 void serialize_value(ostream_size &, const ::ETL::Example::Command &message);
 void serialize_value(ostream_writer &, const ::ETL::Example::Command &message);
 void serialize_value(ostream_buffer &, const ::ETL::Example::Command &message);
 void deserialize_value(istream_reader &, ::ETL::Example::Command &message, tag_type);
 void deserialize_value(istream_buffer &, ::ETL::Example::Command &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::ETL::Example::Command>);
 void serialize_value(ostream_size &, const ::ETL::Example::CommandQueue &message);
 void serialize_value(ostream_writer &, const ::ETL::Example::CommandQueue &message);
 void serialize_value(ostream_buffer &, const ::ETL::Example::CommandQueue &message);
 void deserialize_value(istream_reader &, ::ETL::Example::CommandQueue &message, tag_type);
 void deserialize_value(istream_buffer &, ::ETL::Example::CommandQueue &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::ETL::Example::CommandQueue>);
+void validate_value(istream_buffer &, std::type_identity<::ETL::Example::Command::CMD>);
 } // namespace detail
 } // namespace spb::pb
 namespace spb::json
@@ -181,7 +208,7 @@ namespace spb::json
  * @return serialized size in bytes
  * @throws exceptions only from `on_write`
  */
-size_t serialize(const auto &message, spb::io::writer on_write);
+size_t serialize(const auto &message, spb::io::writer on_write, const serialize_options &options);
 
 /**
  * @brief return JSON serialized size in bytes
@@ -190,9 +217,9 @@ size_t serialize(const auto &message, spb::io::writer on_write);
  * @param[in] options
  * @return serialized size in bytes
  */
-[[nodiscard]] size_t serialize_size(const auto &message);
+[[nodiscard]] size_t serialize_size(const auto &message, const serialize_options &options);
 
-size_t serialize(const auto &message, void *buffer);
+size_t serialize(const auto &message, void *buffer, const serialize_options &options);
 
 /**
  * @brief serialize message into JSON
@@ -205,7 +232,8 @@ size_t serialize(const auto &message, void *buffer);
  * @example `std::string json;`
  *          `spb::json::serialize(message, json);`
  */
-template <spb::resizable_container Container> size_t serialize(const auto &message, Container &result);
+template <spb::resizable_container Container>
+size_t serialize(const auto &message, Container &result, const serialize_options &options);
 
 /**
  * @brief serialize message into JSON
@@ -216,9 +244,10 @@ template <spb::resizable_container Container> size_t serialize(const auto &messa
  * @throws std::runtime_error on error
  * @example `auto serialized_message = spb::json::serialize< std::vector< std::byte > >( message );`
  */
-template <spb::resizable_container Container> [[nodiscard]] Container serialize(const auto &message);
+template <spb::resizable_container Container>
+[[nodiscard]] Container serialize(const auto &message, const serialize_options &options);
 
-size_t deserialize(auto &message, const void *buffer, size_t size);
+size_t deserialize(auto &message, const void *buffer, size_t size, const deserialize_options &options);
 
 /**
  * @brief deserialize message from JSON
@@ -228,7 +257,16 @@ size_t deserialize(auto &message, const void *buffer, size_t size);
  * @param[out] message deserialized message
  * @throws std::runtime_error on error
  */
-size_t deserialize(auto &message, spb::io::reader reader);
+size_t deserialize(auto &message, spb::io::reader reader, const deserialize_options &options);
+
+/**
+ * @brief deserialize message from JSON lent in chunks by the reader, the chunks are parsed in place
+ *
+ * @param[in] reader function lending the chunks
+ * @param[out] message deserialized message
+ * @throws std::runtime_error on error
+ */
+size_t deserialize(auto &message, spb::io::chunk_reader reader);
 
 /**
  * @brief deserialize message from JSON
@@ -241,7 +279,7 @@ size_t deserialize(auto &message, spb::io::reader reader);
  *          `auto message = Message();`
  *          `spb::json::deserialize(message, serialized);`
  */
-size_t deserialize(auto &message, const spb::size_container auto &json);
+size_t deserialize(auto &message, const spb::size_container auto &json, const deserialize_options &options);
 
 /**
  * @brief deserialize message from JSON
@@ -253,7 +291,8 @@ size_t deserialize(auto &message, const spb::size_container auto &json);
  * @example `auto serialized = std::vector<std::byte>( ... );`
  *          `auto message = spb::json::deserialize<Message>(serialized);`
  */
-template <typename Message> [[nodiscard]] Message deserialize(const spb::size_container auto &json);
+template <typename Message>
+[[nodiscard]] Message deserialize(const spb::size_container auto &json, const deserialize_options &options);
 
 /**
  * @brief deserialize message from reader
@@ -263,29 +302,47 @@ template <typename Message> [[nodiscard]] Message deserialize(const spb::size_co
  * @return deserialized message
  * @throws std::runtime_error on error
  */
-template <typename Message> [[nodiscard]] Message deserialize(spb::io::reader reader);
+template <typename Message>
+[[nodiscard]] Message deserialize(spb::io::reader reader, const deserialize_options &options);
+
+/**
+ * @brief deserialize message from JSON lent in chunks by the reader, the chunks are parsed in place
+ *
+ * @param[in] reader function lending the chunks
+ * @return deserialized message
+ * @throws std::runtime_error on error
+ */
+template <typename Message> [[nodiscard]] Message deserialize(spb::io::chunk_reader reader);
 namespace detail
 {
 void serialize_value(ostream_size &, const ::ETL::Example::DeviceStatus &message);
 void serialize_value(ostream_writer &, const ::ETL::Example::DeviceStatus &message);
 void serialize_value(ostream_buffer &, const ::ETL::Example::DeviceStatus &message);
+void serialize_value(ostream_growable &, const ::ETL::Example::DeviceStatus &message);
 void deserialize_value(istream_reader &, ::ETL::Example::DeviceStatus &message);
 void deserialize_value(istream_buffer &, ::ETL::Example::DeviceStatus &message);
+void validate_value(istream_buffer &, std::type_identity<::ETL::Example::DeviceStatus>);
 void serialize_value(ostream_size &, const ::ETL::Example::Command &message);
 void serialize_value(ostream_writer &, const ::ETL::Example::Command &message);
 void serialize_value(ostream_buffer &, const ::ETL::Example::Command &message);
+void serialize_value(ostream_growable &, const ::ETL::Example::Command &message);
 void deserialize_value(istream_reader &, ::ETL::Example::Command &message);
 void deserialize_value(istream_buffer &, ::ETL::Example::Command &message);
+void validate_value(istream_buffer &, std::type_identity<::ETL::Example::Command>);
 void serialize_value(ostream_size &, const ::ETL::Example::CommandQueue &message);
 void serialize_value(ostream_writer &, const ::ETL::Example::CommandQueue &message);
 void serialize_value(ostream_buffer &, const ::ETL::Example::CommandQueue &message);
+void serialize_value(ostream_growable &, const ::ETL::Example::CommandQueue &message);
 void deserialize_value(istream_reader &, ::ETL::Example::CommandQueue &message);
 void deserialize_value(istream_buffer &, ::ETL::Example::CommandQueue &message);
+void validate_value(istream_buffer &, std::type_identity<::ETL::Example::CommandQueue>);
 void serialize_value(ostream_size &, const ::ETL::Example::Command::CMD &message);
 void serialize_value(ostream_writer &, const ::ETL::Example::Command::CMD &message);
 void serialize_value(ostream_buffer &, const ::ETL::Example::Command::CMD &message);
+void serialize_value(ostream_growable &, const ::ETL::Example::Command::CMD &message);
 void deserialize_value(istream_reader &, ::ETL::Example::Command::CMD &message);
 void deserialize_value(istream_buffer &, ::ETL::Example::Command::CMD &message);
+void validate_value(istream_buffer &, std::type_identity<::ETL::Example::Command::CMD>);
 } // namespace detail
 
 } // namespace spb::json
@@ -181,6 +181,17 @@ auto serialize_size(const auto &message, const serialize_options &options) -> si
  */
 auto serialize(const auto &message, void *buffer, const serialize_options &options) -> size_t;
 
+/**
+ * @brief serialize message as a list of chunks (scatter-gather), large `bytes` and `string`
+ *        fields are referenced in place instead of being copied
+ *
+ * @param[in] message to be serialized
+ * @param[out] builder chunks of the serialized message
+ * @param[in] options
+ * @return serialized size in bytes
+ */
+auto serialize_iov(const auto &message, iovec_builder &builder, const serialize_options &options) -> size_t;
+
 /**
  * @brief serialize message into protobuf
  *
@@ -244,6 +255,18 @@ auto deserialize(Message &message, const Container &protobuf, const deserialize_
 template <typename Message, spb::size_container Container>
 auto deserialize(const Container &protobuf, const deserialize_options &options) -> Message;
 
+/**
+ * @brief deserialize message from a chain of (non-contiguous) segments, without concatenating them
+ *
+ * @param[in] segments message split into segments (like a network buffer chain)
+ * @param[in] options
+ * @param[out] message deserialized message
+ * @return consumed size in bytes
+ * @throws std::runtime_error on error
+ */
+auto deserialize(auto &message, std::span<const std::span<const std::byte>> segments,
+                 const deserialize_options &options) -> size_t;
+
 /**
  * @brief deserialize message from reader
  *
@@ -262,66 +285,79 @@ void serialize_value(ostream_writer &, const ::SPB::Options::Integers &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Integers &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Integers &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Integers &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Integers>);
 void serialize_value(ostream_size &, const ::SPB::Options::BitFields &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::BitFields &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::BitFields &message);
 void deserialize_value(istream_reader &, ::SPB::Options::BitFields &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::BitFields &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::BitFields>);
 void serialize_value(ostream_size &, const ::SPB::Options::MaximumCount &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::MaximumCount &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::MaximumCount &message);
 void deserialize_value(istream_reader &, ::SPB::Options::MaximumCount &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::MaximumCount &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::MaximumCount>);
 void serialize_value(ostream_size &, const ::SPB::Options::MaximumSize &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::MaximumSize &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::MaximumSize &message);
 void deserialize_value(istream_reader &, ::SPB::Options::MaximumSize &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::MaximumSize &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::MaximumSize>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers>);
 void serialize_value(ostream_size &, const ::SPB::Options::MaximumCount::Person &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::MaximumCount::Person &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::MaximumCount::Person &message);
 void deserialize_value(istream_reader &, ::SPB::Options::MaximumCount::Person &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::MaximumCount::Person &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::MaximumCount::Person>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Repeated &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Repeated &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Repeated &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Repeated &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Repeated &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Repeated>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::String &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::String &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::String &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::String &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::String &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::String>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Bytes &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Bytes &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Bytes &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Bytes &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Bytes &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Bytes>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Maps &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Maps &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Maps &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Maps &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Maps &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Maps>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Optional &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Optional &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Optional &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Optional &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Optional &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Optional>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::String::SubStrings &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::String::SubStrings &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::String::SubStrings &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::String::SubStrings &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::String::SubStrings &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::String::SubStrings>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Bytes::SubBytes &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Bytes::SubBytes &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Bytes::SubBytes &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Bytes::SubBytes &message, tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Bytes::SubBytes &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Bytes::SubBytes>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Optional::CyclicDependency &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Optional::CyclicDependency &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Optional::CyclicDependency &message);
@@ -329,6 +365,8 @@ void deserialize_value(istream_reader &, ::SPB::Options::Containers::Optional::C
                        tag_type);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Optional::CyclicDependency &message,
                        tag_type);
+void validate_value(istream_buffer &,
+                    std::type_identity<::SPB::Options::Containers::Optional::CyclicDependency>);
 void serialize_value(ostream_size &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageA &message);
 void serialize_value(ostream_writer &,
@@ -339,6 +377,8 @@ void deserialize_value(istream_reader &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageA &message, tag_type);
 void deserialize_value(istream_buffer &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageA &message, tag_type);
+void validate_value(istream_buffer &,
+                    std::type_identity<::SPB::Options::Containers::Optional::CyclicDependency::MessageA>);
 void serialize_value(ostream_size &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageC &message);
 void serialize_value(ostream_writer &,
@@ -349,6 +389,8 @@ void deserialize_value(istream_reader &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageC &message, tag_type);
 void deserialize_value(istream_buffer &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageC &message, tag_type);
+void validate_value(istream_buffer &,
+                    std::type_identity<::SPB::Options::Containers::Optional::CyclicDependency::MessageC>);
 void serialize_value(ostream_size &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageB &message);
 void serialize_value(ostream_writer &,
@@ -359,6 +401,10 @@ void deserialize_value(istream_reader &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageB &message, tag_type);
 void deserialize_value(istream_buffer &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageB &message, tag_type);
+void validate_value(istream_buffer &,
+                    std::type_identity<::SPB::Options::Containers::Optional::CyclicDependency::MessageB>);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Enum8>);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Enum16>);
 } // namespace detail
 } // namespace spb::pb
 namespace spb::json
@@ -372,7 +418,7 @@ namespace spb::json
  * @return serialized size in bytes
  * @throws exceptions only from `on_write`
  */
-size_t serialize(const auto &message, spb::io::writer on_write);
+size_t serialize(const auto &message, spb::io::writer on_write, const serialize_options &options);
 
 /**
  * @brief return JSON serialized size in bytes
@@ -381,9 +427,9 @@ size_t serialize(const auto &message, spb::io::writer on_write);
  * @param[in] options
  * @return serialized size in bytes
  */
-[[nodiscard]] size_t serialize_size(const auto &message);
+[[nodiscard]] size_t serialize_size(const auto &message, const serialize_options &options);
 
-size_t serialize(const auto &message, void *buffer);
+size_t serialize(const auto &message, void *buffer, const serialize_options &options);
 
 /**
  * @brief serialize message into JSON
@@ -396,7 +442,8 @@ size_t serialize(const auto &message, void *buffer);
  * @example `std::string json;`
  *          `spb::json::serialize(message, json);`
  */
-template <spb::resizable_container Container> size_t serialize(const auto &message, Container &result);
+template <spb::resizable_container Container>
+size_t serialize(const auto &message, Container &result, const serialize_options &options);
 
 /**
  * @brief serialize message into JSON
@@ -407,9 +454,10 @@ template <spb::resizable_container Container> size_t serialize(const auto &messa
  * @throws std::runtime_error on error
  * @example `auto serialized_message = spb::json::serialize< std::vector< std::byte > >( message );`
  */
-template <spb::resizable_container Container> [[nodiscard]] Container serialize(const auto &message);
+template <spb::resizable_container Container>
+[[nodiscard]] Container serialize(const auto &message, const serialize_options &options);
 
-size_t deserialize(auto &message, const void *buffer, size_t size);
+size_t deserialize(auto &message, const void *buffer, size_t size, const deserialize_options &options);
 
 /**
  * @brief deserialize message from JSON
@@ -419,7 +467,16 @@ size_t deserialize(auto &message, const void *buffer, size_t size);
  * @param[out] message deserialized message
  * @throws std::runtime_error on error
  */
-size_t deserialize(auto &message, spb::io::reader reader);
+size_t deserialize(auto &message, spb::io::reader reader, const deserialize_options &options);
+
+/**
+ * @brief deserialize message from JSON lent in chunks by the reader, the chunks are parsed in place
+ *
+ * @param[in] reader function lending the chunks
+ * @param[out] message deserialized message
+ * @throws std::runtime_error on error
+ */
+size_t deserialize(auto &message, spb::io::chunk_reader reader);
 
 /**
  * @brief deserialize message from JSON
@@ -432,7 +489,7 @@ size_t deserialize(auto &message, spb::io::reader reader);
  *          `auto message = Message();`
  *          `spb::json::deserialize(message, serialized);`
  */
-size_t deserialize(auto &message, const spb::size_container auto &json);
+size_t deserialize(auto &message, const spb::size_container auto &json, const deserialize_options &options);
 
 /**
  * @brief deserialize message from JSON
@@ -444,7 +501,8 @@ size_t deserialize(auto &message, const spb::size_container auto &json);
  * @example `auto serialized = std::vector<std::byte>( ... );`
  *          `auto message = spb::json::deserialize<Message>(serialized);`
  */
-template <typename Message> [[nodiscard]] Message deserialize(const spb::size_container auto &json);
+template <typename Message>
+[[nodiscard]] Message deserialize(const spb::size_container auto &json, const deserialize_options &options);
 
 /**
  * @brief deserialize message from reader
@@ -454,119 +512,175 @@ template <typename Message> [[nodiscard]] Message deserialize(const spb::size_co
  * @return deserialized message
  * @throws std::runtime_error on error
  */
-template <typename Message> [[nodiscard]] Message deserialize(spb::io::reader reader);
+template <typename Message>
+[[nodiscard]] Message deserialize(spb::io::reader reader, const deserialize_options &options);
+
+/**
+ * @brief deserialize message from JSON lent in chunks by the reader, the chunks are parsed in place
+ *
+ * @param[in] reader function lending the chunks
+ * @return deserialized message
+ * @throws std::runtime_error on error
+ */
+template <typename Message> [[nodiscard]] Message deserialize(spb::io::chunk_reader reader);
 namespace detail
 {
 void serialize_value(ostream_size &, const ::SPB::Options::Integers &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Integers &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Integers &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Integers &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Integers &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Integers &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Integers>);
 void serialize_value(ostream_size &, const ::SPB::Options::BitFields &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::BitFields &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::BitFields &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::BitFields &message);
 void deserialize_value(istream_reader &, ::SPB::Options::BitFields &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::BitFields &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::BitFields>);
 void serialize_value(ostream_size &, const ::SPB::Options::MaximumCount &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::MaximumCount &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::MaximumCount &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::MaximumCount &message);
 void deserialize_value(istream_reader &, ::SPB::Options::MaximumCount &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::MaximumCount &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::MaximumCount>);
 void serialize_value(ostream_size &, const ::SPB::Options::MaximumSize &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::MaximumSize &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::MaximumSize &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::MaximumSize &message);
 void deserialize_value(istream_reader &, ::SPB::Options::MaximumSize &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::MaximumSize &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::MaximumSize>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Containers &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers>);
 void serialize_value(ostream_size &, const ::SPB::Options::MaximumCount::Person &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::MaximumCount::Person &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::MaximumCount::Person &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::MaximumCount::Person &message);
 void deserialize_value(istream_reader &, ::SPB::Options::MaximumCount::Person &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::MaximumCount::Person &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::MaximumCount::Person>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Repeated &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Repeated &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Repeated &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Containers::Repeated &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Repeated &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Repeated &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Repeated>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::String &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::String &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::String &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Containers::String &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::String &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::String &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::String>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Bytes &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Bytes &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Bytes &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Containers::Bytes &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Bytes &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Bytes &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Bytes>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Maps &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Maps &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Maps &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Containers::Maps &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Maps &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Maps &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Maps>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Optional &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Optional &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Optional &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Containers::Optional &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Optional &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Optional &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Optional>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::String::SubStrings &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::String::SubStrings &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::String::SubStrings &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Containers::String::SubStrings &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::String::SubStrings &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::String::SubStrings &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::String::SubStrings>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Bytes::SubBytes &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Bytes::SubBytes &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Bytes::SubBytes &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Containers::Bytes::SubBytes &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Bytes::SubBytes &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Bytes::SubBytes &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Containers::Bytes::SubBytes>);
 void serialize_value(ostream_size &, const ::SPB::Options::Containers::Optional::CyclicDependency &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Containers::Optional::CyclicDependency &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Containers::Optional::CyclicDependency &message);
+void serialize_value(ostream_growable &,
+                     const ::SPB::Options::Containers::Optional::CyclicDependency &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Containers::Optional::CyclicDependency &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Containers::Optional::CyclicDependency &message);
+void validate_value(istream_buffer &,
+                    std::type_identity<::SPB::Options::Containers::Optional::CyclicDependency>);
 void serialize_value(ostream_size &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageA &message);
 void serialize_value(ostream_writer &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageA &message);
 void serialize_value(ostream_buffer &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageA &message);
+void serialize_value(ostream_growable &,
+                     const ::SPB::Options::Containers::Optional::CyclicDependency::MessageA &message);
 void deserialize_value(istream_reader &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageA &message);
 void deserialize_value(istream_buffer &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageA &message);
+void validate_value(istream_buffer &,
+                    std::type_identity<::SPB::Options::Containers::Optional::CyclicDependency::MessageA>);
 void serialize_value(ostream_size &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageC &message);
 void serialize_value(ostream_writer &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageC &message);
 void serialize_value(ostream_buffer &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageC &message);
+void serialize_value(ostream_growable &,
+                     const ::SPB::Options::Containers::Optional::CyclicDependency::MessageC &message);
 void deserialize_value(istream_reader &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageC &message);
 void deserialize_value(istream_buffer &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageC &message);
+void validate_value(istream_buffer &,
+                    std::type_identity<::SPB::Options::Containers::Optional::CyclicDependency::MessageC>);
 void serialize_value(ostream_size &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageB &message);
 void serialize_value(ostream_writer &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageB &message);
 void serialize_value(ostream_buffer &,
                      const ::SPB::Options::Containers::Optional::CyclicDependency::MessageB &message);
+void serialize_value(ostream_growable &,
+                     const ::SPB::Options::Containers::Optional::CyclicDependency::MessageB &message);
 void deserialize_value(istream_reader &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageB &message);
 void deserialize_value(istream_buffer &,
                        ::SPB::Options::Containers::Optional::CyclicDependency::MessageB &message);
+void validate_value(istream_buffer &,
+                    std::type_identity<::SPB::Options::Containers::Optional::CyclicDependency::MessageB>);
 void serialize_value(ostream_size &, const ::SPB::Options::Enum8 &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Enum8 &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Enum8 &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Enum8 &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Enum8 &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Enum8 &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Enum8>);
 void serialize_value(ostream_size &, const ::SPB::Options::Enum16 &message);
 void serialize_value(ostream_writer &, const ::SPB::Options::Enum16 &message);
 void serialize_value(ostream_buffer &, const ::SPB::Options::Enum16 &message);
+void serialize_value(ostream_growable &, const ::SPB::Options::Enum16 &message);
 void deserialize_value(istream_reader &, ::SPB::Options::Enum16 &message);
 void deserialize_value(istream_buffer &, ::SPB::Options::Enum16 &message);
+void validate_value(istream_buffer &, std::type_identity<::SPB::Options::Enum16>);
 } // namespace detail
 
 } // namespace spb::json
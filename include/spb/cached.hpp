@@ -0,0 +1,145 @@
+/***************************************************************************\
+* Name        : cached message                                              *
+* Description : sub-message wrapper with memoized protobuf encoding         *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+#pragma once
+
+#include "pb.hpp"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace spb
+{
+/**
+ * @brief sub-message wrapper which memoizes its protobuf encoding
+ *        the message is encoded on the first serialize (or serialize_size) and
+ *        the encoded bytes are reused until the next mutable access
+ *        use `(spb_opt).cached = true` for a message field to generate it
+ *
+ * @note const methods (serialize, `encoded()`) are safe to call concurrently, the first one
+ *       fills the cache under a lock, the others wait for it
+ *       non-const methods (`mutable_value()`, `invalidate()`, assignment) need exclusive access
+ */
+template <typename T> class cached
+{
+  public:
+    using message_type = T;
+
+    cached() = default;
+
+    cached(const T &message) : message_(message)
+    {
+    }
+
+    cached(T &&message) noexcept : message_(std::move(message))
+    {
+    }
+
+    cached(const cached &other) : message_(other.message_)
+    {
+        if (other.valid_.load(std::memory_order_acquire))
+        {
+            encoded_ = other.encoded_;
+            valid_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    cached(cached &&other) noexcept : message_(std::move(other.message_))
+    {
+        if (other.valid_.exchange(false, std::memory_order_acquire))
+        {
+            encoded_ = std::move(other.encoded_);
+            valid_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    auto operator=(const cached &other) -> cached &
+    {
+        if (this != &other)
+        {
+            *this = cached(other);
+        }
+        return *this;
+    }
+
+    auto operator=(cached &&other) noexcept -> cached &
+    {
+        message_ = std::move(other.message_);
+        invalidate();
+        if (other.valid_.exchange(false, std::memory_order_acquire))
+        {
+            encoded_ = std::move(other.encoded_);
+            valid_.store(true, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief read-only access, keeps the cache
+     */
+    [[nodiscard]] auto value() const noexcept -> const T &
+    {
+        return message_;
+    }
+
+    [[nodiscard]] auto operator*() const noexcept -> const T &
+    {
+        return message_;
+    }
+
+    [[nodiscard]] auto operator->() const noexcept -> const T *
+    {
+        return &message_;
+    }
+
+    /**
+     * @brief mutable access, invalidates the cache
+     */
+    [[nodiscard]] auto mutable_value() noexcept -> T &
+    {
+        invalidate();
+        return message_;
+    }
+
+    void invalidate() noexcept
+    {
+        valid_.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief protobuf encoded message (without tag and length), encoded on the first call
+     *        thread-safe, concurrent callers encode the message only once
+     *
+     * @throws std::runtime_error on error
+     */
+    [[nodiscard]] auto encoded() const -> std::span<const std::byte>
+    {
+        if (!valid_.load(std::memory_order_acquire)) [[unlikely]]
+        {
+            auto lock = std::lock_guard(fill_);
+            if (!valid_.load(std::memory_order_relaxed))
+            {
+                spb::pb::serialize(message_, encoded_);
+                valid_.store(true, std::memory_order_release);
+            }
+        }
+        return encoded_;
+    }
+
+  private:
+    T message_{};
+    //- `encoded_` is written only under `fill_` before `valid_` is released
+    mutable std::vector<std::byte> encoded_;
+    mutable std::atomic<bool> valid_ = false;
+    mutable std::mutex fill_;
+};
+} // namespace spb
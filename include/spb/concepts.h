@@ -11,6 +11,9 @@
 
 #include <concepts>
 #include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
 #include <type_traits>
 
 namespace spb
@@ -28,7 +31,7 @@ concept size_container = requires(T container) {
     { container.data() };
     { container.size() } -> std::convertible_to<std::size_t>;
     typename std::decay_t<T>::value_type;
-    { sizeof(typename std::decay_t<T>::value_type) == sizeof(char) };
+    requires sizeof(typename std::decay_t<T>::value_type) == sizeof(char);
 };
 
 namespace detail
@@ -61,7 +64,29 @@ concept proto_field_bytes_resizable = proto_field_bytes<T> && requires(T obj) {
 };
 
 template <class T>
-concept proto_field_string = container<T> && std::is_same_v<typename std::decay_t<T>::value_type, char>;
+concept proto_field_raw = proto_field_bytes<T> && requires(T obj) {
+    typename std::decay_t<T>::message_type;
+    { obj.decode() } -> std::same_as<typename std::decay_t<T>::message_type>;
+};
+
+//- read-only string (std::string_view, spb::json_string), deserialize points it into the input if possible
+template <class T>
+concept proto_field_string_view = requires(T obj) {
+    { obj.data() } -> std::same_as<const char *>;
+    { obj.size() } -> std::convertible_to<std::size_t>;
+    { obj = std::string_view() };
+    typename std::decay_t<T>::value_type;
+} && std::is_same_v<typename std::decay_t<T>::value_type, char>;
+
+//- read-only string which can also own a copy (escaped JSON string, non contiguous input)
+template <class T>
+concept proto_field_string_view_owning = proto_field_string_view<T> && requires(T obj) {
+    { obj.own(std::string()) };
+};
+
+template <class T>
+concept proto_field_string = (container<T> && std::is_same_v<typename std::decay_t<T>::value_type, char>) ||
+                             proto_field_string_view<T>;
 
 template <class T>
 concept proto_field_string_resizable = proto_field_string<T> && requires(T obj) {
@@ -106,10 +131,26 @@ concept proto_label_optional = requires(T container) {
     typename T::value_type;
 };
 
+template <class T>
+concept proto_cached = requires(T obj) {
+    typename std::decay_t<T>::message_type;
+    { obj.value() };
+    { obj.mutable_value() };
+    { obj.encoded() };
+};
+
+template <class T>
+concept proto_field_stream_bytes = requires(T obj) {
+    { obj.push(std::span<const std::byte>()) };
+    { obj.pull(std::span<std::byte>()) };
+    { obj.size() } -> std::convertible_to<std::size_t>;
+};
+
 template <class T>
 concept proto_message =
     std::is_class_v<T> && !proto_field_string<T> && !proto_field_bytes<T> && !proto_label_repeated<T> &&
-    !proto_label_repeated_fixed_size<T> && !proto_label_optional<T> && !proto_map<T>;
+    !proto_label_repeated_fixed_size<T> && !proto_label_optional<T> && !proto_map<T> && !proto_cached<T> &&
+    !proto_field_stream_bytes<T>;
 
 } // namespace detail
 } // namespace spb
@@ -0,0 +1,137 @@
+/***************************************************************************\
+* Name        : field mask                                                  *
+* Description : selection of (nested) fields by their field numbers         *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace spb
+{
+/**
+ * @brief set of field paths, every path is a list of field numbers from the top level message
+ *        path `{4}` selects the whole field 4, path `{4, 2}` selects only field 2 of the sub-message 4
+ *
+ * @example `auto mask = spb::field_mask{{1}, {4, 2}};`
+ */
+class field_mask
+{
+  public:
+    field_mask() = default;
+
+    field_mask(std::initializer_list<std::initializer_list<uint32_t>> paths)
+    {
+        for (const auto &path : paths)
+            add(std::span<const uint32_t>(path.begin(), path.size()));
+    }
+
+    /**
+     * @brief add field path into the mask
+     *
+     * @param path field numbers, from the top level message
+     */
+    void add(std::span<const uint32_t> path)
+    {
+        auto *p_node = this;
+        for (auto number : path)
+        {
+            if (p_node->all_)
+                return;
+
+            p_node = &p_node->insert(number);
+        }
+        p_node->all_ = true;
+        p_node->children_.clear();
+    }
+
+    /**
+     * @brief is the field selected
+     */
+    [[nodiscard]] auto contains(uint32_t number) const noexcept -> bool
+    {
+        return all_ || find(number) != nullptr;
+    }
+
+    /**
+     * @brief mask for fields of the sub-message `number`
+     *
+     * @return nullptr if the whole field is selected (or if it is not selected at all)
+     */
+    [[nodiscard]] auto child(uint32_t number) const noexcept -> const field_mask *
+    {
+        if (all_)
+            return nullptr;
+
+        const auto *p_child = find(number);
+        return (p_child && !p_child->all_) ? p_child : nullptr;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return !all_ && children_.empty();
+    }
+
+  private:
+    uint32_t number_ = 0;
+    bool all_        = false;
+    //- sorted by `number_`
+    std::vector<field_mask> children_;
+
+    [[nodiscard]] auto find(uint32_t number) const noexcept -> const field_mask *
+    {
+        const auto it = std::lower_bound(children_.begin(), children_.end(), number,
+                                         [](const field_mask &child, uint32_t n) { return child.number_ < n; });
+        return (it != children_.end() && it->number_ == number) ? &*it : nullptr;
+    }
+
+    auto insert(uint32_t number) -> field_mask &
+    {
+        auto it = std::lower_bound(children_.begin(), children_.end(), number,
+                                   [](const field_mask &child, uint32_t n) { return child.number_ < n; });
+        if (it == children_.end() || it->number_ != number)
+        {
+            it          = children_.emplace(it);
+            it->number_ = number;
+        }
+        return *it;
+    }
+};
+
+/**
+ * @brief compile-time selection of top level fields
+ *
+ * @example `auto person = spb::pb::deserialize<Person, spb::fields<1, 4>>(buffer);`
+ */
+template <uint32_t... Numbers> struct fields
+{
+    [[nodiscard]] static auto mask() -> const field_mask &
+    {
+        static const auto result = field_mask{{Numbers}...};
+        return result;
+    }
+};
+
+namespace detail
+{
+template <typename T> struct is_fields : std::false_type
+{
+};
+
+template <uint32_t... Numbers> struct is_fields<spb::fields<Numbers...>> : std::true_type
+{
+};
+
+template <class T>
+concept field_selection = is_fields<T>::value;
+} // namespace detail
+} // namespace spb
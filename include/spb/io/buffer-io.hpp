@@ -10,79 +10,188 @@
 
 #pragma once
 #include "io.hpp"
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
 #include <string_view>
 #include <sys/types.h>
 
 namespace spb::io
 {
+/**
+ * @brief buffer between a reader and the parser
+ *        `io::reader` copies the input into the buffer (heap allocated or provided by the user),
+ *        `io::chunk_reader` lends its own chunks which are used in place, only a view spanning two chunks
+ *        is stitched together in a small internal buffer
+ */
 class buffered_reader
 {
   public:
-    static constexpr size_t BUFFER_SIZE = 256;
+    //- longest view which is guaranteed to fit into the buffer, buffers are never smaller
+    static constexpr size_t MIN_BUFFER_SIZE = 256;
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
 
   private:
-    using buffer_index_type = uint16_t;
-    std::array<char, BUFFER_SIZE> buffer;
     io::reader on_read;
-    buffer_index_type begin_index = 0;
-    buffer_index_type end_index = 0;
+    io::chunk_reader on_chunk;
+    std::array<char, MIN_BUFFER_SIZE> small_buffer;
+    std::unique_ptr<char[]> heap_buffer;
+    std::span<char> buffer;
+    //- buffered data, either in `buffer` or in the lent chunk
+    const char *p_begin = nullptr;
+    const char *p_end = nullptr;
+    bool lent = false;
+    //- rest of the lent chunk behind the data stitched in `buffer`, `from_pending` bytes in front of it
+    //- are the last bytes of the buffer
+    std::string_view pending;
+    size_t from_pending = 0;
     bool eof_reached = false;
 
     auto bytes_in_buffer() const noexcept -> size_t
     {
-        return end_index - begin_index;
-    }
-
-    auto space_left_in_buffer() const noexcept -> size_t
-    {
-        return buffer.size() - end_index;
+        return p_end - p_begin;
     }
 
     void shift_data_to_start() noexcept
     {
-        if (begin_index == 0)
-            return;
+        const auto size = bytes_in_buffer();
+        if (p_begin != buffer.data() && size > 0)
+            memmove(buffer.data(), p_begin, size);
 
-        memmove(buffer.data(), buffer.data() + begin_index, bytes_in_buffer());
-        end_index -= begin_index;
-        begin_index = 0;
+        p_begin = buffer.data();
+        p_end = p_begin + size;
     }
 
-    void read_buffer()
+    void read_buffer(size_t minimal_size)
     {
         shift_data_to_start();
 
-        while (bytes_in_buffer() < buffer.size() && !eof_reached)
+        //- one read can fill the whole buffer, but it is not required to
+        while (bytes_in_buffer() < minimal_size && !eof_reached)
         {
-            auto bytes_in =
-                static_cast<buffer_index_type>(on_read(&buffer[end_index], space_left_in_buffer()));
+            auto bytes_in = on_read(buffer.data() + bytes_in_buffer(), buffer.size() - bytes_in_buffer());
             eof_reached |= bytes_in == 0;
-            end_index += bytes_in;
+            p_end += bytes_in;
+        }
+    }
+
+    void read_chunk(size_t minimal_size)
+    {
+        //- data stitched from the previous chunk were consumed, continue in place in the current one
+        if (!lent && bytes_in_buffer() <= from_pending)
+        {
+            p_begin = pending.data() - bytes_in_buffer();
+            p_end = pending.data() + pending.size();
+            lent = true;
+            pending = {};
+            from_pending = 0;
+        }
+
+        while (bytes_in_buffer() == 0 && !eof_reached)
+        {
+            const auto chunk = on_chunk();
+            eof_reached |= chunk.empty();
+            p_begin = chunk.data();
+            p_end = p_begin + chunk.size();
+            lent = true;
+        }
+
+        if (bytes_in_buffer() >= minimal_size || eof_reached)
+            return;
+
+        //- the view spans two chunks, the rest of the current one has to be copied because it is valid
+        //- only until the next `on_chunk` call
+        const auto size = bytes_in_buffer();
+        memmove(buffer.data(), p_begin, size);
+        p_begin = buffer.data();
+        p_end = p_begin + size;
+        lent = false;
+
+        while (bytes_in_buffer() < minimal_size && !eof_reached)
+        {
+            if (pending.empty())
+            {
+                pending = on_chunk();
+                eof_reached |= pending.empty();
+                from_pending = 0;
+                continue;
+            }
+            const auto copy_size = std::min(pending.size(), minimal_size - bytes_in_buffer());
+            memcpy(buffer.data() + bytes_in_buffer(), pending.data(), copy_size);
+            pending.remove_prefix(copy_size);
+            from_pending += copy_size;
+            p_end += copy_size;
         }
     }
 
   public:
-    explicit buffered_reader(io::reader reader) : on_read(reader)
+    /**
+     * @param reader input copied into a heap allocated buffer
+     * @param buffer_size size of the buffer, at least `MIN_BUFFER_SIZE`
+     */
+    explicit buffered_reader(io::reader reader, size_t buffer_size = DEFAULT_BUFFER_SIZE) : on_read(reader)
+    {
+        buffer_size = std::max(buffer_size, MIN_BUFFER_SIZE);
+        heap_buffer = std::make_unique_for_overwrite<char[]>(buffer_size);
+        buffer = {heap_buffer.get(), buffer_size};
+        p_begin = p_end = buffer.data();
+    }
+
+    /**
+     * @param reader input copied into `user_buffer`
+     * @param user_buffer buffer (e.g. arena backed) used instead of a heap allocated one, it has to outlive
+     *        the reader and it has to have at least `MIN_BUFFER_SIZE` bytes
+     */
+    buffered_reader(io::reader reader, std::span<char> user_buffer) : on_read(reader), buffer(user_buffer)
+    {
+        if (buffer.size() < MIN_BUFFER_SIZE) [[unlikely]]
+            throw std::length_error("too small reader buffer");
+
+        p_begin = p_end = buffer.data();
+    }
+
+    /**
+     * @param reader input used in place (zero-copy)
+     */
+    explicit buffered_reader(io::chunk_reader reader) : on_chunk(reader)
     {
+        buffer = small_buffer;
+        p_begin = p_end = buffer.data();
     }
 
+    buffered_reader(const buffered_reader &) = delete;
+    auto operator=(const buffered_reader &) -> buffered_reader & = delete;
+
+    /**
+     * @brief view of the buffered input, shorter than `minimal_size` only at the end of the input
+     *
+     * @param minimal_size up to `MIN_BUFFER_SIZE`
+     */
     [[nodiscard]] auto view(size_t minimal_size) -> std::string_view
     {
+        assert(minimal_size <= MIN_BUFFER_SIZE);
+
         minimal_size = std::max<size_t>(minimal_size, 1U);
         if (bytes_in_buffer() < minimal_size)
-            read_buffer();
+        {
+            if (on_chunk)
+                read_chunk(minimal_size);
+            else
+                read_buffer(minimal_size);
+        }
 
-        return std::string_view(&buffer[begin_index], bytes_in_buffer());
+        return std::string_view(p_begin, bytes_in_buffer());
     }
 
     void skip(size_t size) noexcept
     {
         assert(size <= bytes_in_buffer());
-        begin_index += static_cast<buffer_index_type>(size);
+        p_begin += size;
     }
 };
 
@@ -11,6 +11,7 @@
 #pragma once
 #include "function_ref.hpp"
 #include <cstdlib>
+#include <string_view>
 
 namespace spb::io
 {
@@ -36,4 +37,14 @@ using writer = spb::detail::function_ref<void(const void *p_data, size_t size)>;
  */
 using reader = spb::detail::function_ref<size_t(void *p_data, size_t size)>;
 
+/**
+ * @brief generic zero-copy reader which lends its own buffers (memory mapped file, received packets, ...)
+ *
+ * @return next chunk of the input, it has to stay valid until the next call. Empty chunk indicates
+ *         end-of-file
+ * @throws any exception thrown will stop the `deserialize` process and will be propagated to the
+ *         caller of `spb::json::deserialize`
+ */
+using chunk_reader = spb::detail::function_ref<std::string_view()>;
+
 } // namespace spb::io
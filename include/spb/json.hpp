@@ -14,10 +14,43 @@
 #include "json/deserialize.hpp"
 #include "json/field.hpp"
 #include "json/serialize.hpp"
+#include "json/validate.hpp"
+#include <array>
 #include <cstdlib>
+#include <span>
 
 namespace spb::json
 {
+struct serialize_options
+{
+    /**
+     * @brief Serialize only the selected fields (and nested paths), nullptr serializes all fields.
+     */
+    const spb::field_mask *mask = nullptr;
+    /**
+     * @brief Escape non ASCII characters in strings as `\uXXXX`, false writes them as they are (UTF-8).
+     */
+    bool escape_unicode = true;
+};
+
+struct deserialize_options
+{
+    /**
+     * @brief Index all token starts of the input in one vectorized pass first, the parser then jumps over
+     *        white spaces and string contents. Pays off for large, pretty-printed or string heavy inputs.
+     */
+    bool structural_index = false;
+    /**
+     * @brief Size of the heap allocated buffer between `spb::io::reader` and the parser.
+     */
+    size_t reader_buffer_size = spb::io::buffered_reader::DEFAULT_BUFFER_SIZE;
+    /**
+     * @brief Buffer (e.g. arena backed) used for `spb::io::reader` instead of a heap allocated one, it needs
+     *        at least `spb::io::buffered_reader::MIN_BUFFER_SIZE` bytes.
+     */
+    std::span<char> reader_buffer;
+};
+
 /**
  * @brief serialize message via writer
  *
@@ -27,9 +60,11 @@ namespace spb::json
  * @return serialized size in bytes
  * @throws exceptions only from `on_write`
  */
-size_t serialize(const auto &message, spb::io::writer on_write)
+size_t serialize(const auto &message, spb::io::writer on_write, const serialize_options &options = {})
 {
-    auto stream = detail::ostream_writer{on_write};
+    auto stream           = detail::ostream_writer{on_write};
+    stream.p_mask         = options.mask;
+    stream.escape_unicode = options.escape_unicode;
     detail::serialize<detail::field_attributes{}>(stream, message);
     return stream.size;
 }
@@ -41,15 +76,17 @@ size_t serialize(const auto &message, spb::io::writer on_write)
  * @param[in] options
  * @return serialized size in bytes
  */
-[[nodiscard]] size_t serialize_size(const auto &message)
+[[nodiscard]] size_t serialize_size(const auto &message, const serialize_options &options = {})
 {
-    return detail::serialize_size(message);
+    return detail::serialize_size(message, options.mask, options.escape_unicode);
 }
 
-size_t serialize(const auto &message, void *buffer)
+size_t serialize(const auto &message, void *buffer, const serialize_options &options = {})
 {
-    const auto start = (uint8_t *)buffer;
-    auto stream      = detail::ostream_buffer((uint8_t *)buffer);
+    const auto start      = (uint8_t *)buffer;
+    auto stream           = detail::ostream_buffer((uint8_t *)buffer);
+    stream.p_mask         = options.mask;
+    stream.escape_unicode = options.escape_unicode;
     detail::serialize<detail::field_attributes{}>(stream, message);
     return stream.p_buffer - start;
 }
@@ -65,13 +102,17 @@ size_t serialize(const auto &message, void *buffer)
  * @example `std::string json;`
  *          `spb::json::serialize(message, json);`
  */
-template <spb::resizable_container Container> size_t serialize(const auto &message, Container &result)
+template <spb::resizable_container Container>
+size_t serialize(const auto &message, Container &result, const serialize_options &options = {})
 {
     static_assert(sizeof(*result.data()) == sizeof(uint8_t));
 
-    const auto size = detail::serialize_size(message);
-    result.resize(size);
-    return serialize(message, result.data());
+    auto stream           = detail::ostream_growable(result);
+    stream.p_mask         = options.mask;
+    stream.escape_unicode = options.escape_unicode;
+    detail::serialize<detail::field_attributes{}>(stream, message);
+    result.resize(stream.size());
+    return stream.size();
 }
 
 /**
@@ -84,16 +125,40 @@ template <spb::resizable_container Container> size_t serialize(const auto &messa
  * @example `auto serialized_message = spb::json::serialize< std::vector< std::byte > >( message );`
  */
 template <spb::resizable_container Container = std::string>
-[[nodiscard]] Container serialize(const auto &message)
+[[nodiscard]] Container serialize(const auto &message, const serialize_options &options = {})
 {
     auto result = Container();
-    serialize(message, result);
+    serialize(message, result, options);
     return result;
 }
 
-size_t deserialize(auto &message, const void *buffer, size_t size)
+/**
+ * @brief serialize only the selected top level fields into JSON, see `serialize_options::mask` for
+ *        nested paths
+ *
+ * @param[in] message to be serialized
+ * @return serialized JSON
+ * @throws std::runtime_error on error
+ * @example `auto json = spb::json::serialize< spb::fields< 1, 4 > >( person );`
+ */
+template <spb::detail::field_selection Fields, spb::resizable_container Container = std::string>
+[[nodiscard]] Container serialize(const auto &message)
+{
+    return serialize<Container>(message, serialize_options{.mask = &Fields::mask()});
+}
+
+size_t deserialize(auto &message, const void *buffer, size_t size, const deserialize_options &options = {})
 {
     detail::istream_buffer stream((const uint8_t *)buffer, size);
+    if (!options.structural_index)
+    {
+        deserialize<detail::field_attributes{}>(stream, message);
+        return size - stream.size();
+    }
+
+    const auto index = detail::build_structural_index(std::string_view((const char *)buffer, size));
+    stream.p_base    = (const uint8_t *)buffer;
+    stream.p_token   = index.data();
     deserialize<detail::field_attributes{}>(stream, message);
     return size - stream.size();
 }
@@ -106,7 +171,28 @@ size_t deserialize(auto &message, const void *buffer, size_t size)
  * @param[out] message deserialized message
  * @throws std::runtime_error on error
  */
-size_t deserialize(auto &message, spb::io::reader reader)
+size_t deserialize(auto &message, spb::io::reader reader, const deserialize_options &options = {})
+{
+    if (!options.reader_buffer.empty())
+    {
+        detail::istream_reader stream{reader, options.reader_buffer};
+        deserialize<detail::field_attributes{}>(stream, message);
+        return stream.consumed_size();
+    }
+
+    detail::istream_reader stream{reader, options.reader_buffer_size};
+    deserialize<detail::field_attributes{}>(stream, message);
+    return stream.consumed_size();
+}
+
+/**
+ * @brief deserialize message from JSON lent in chunks by the reader, the chunks are parsed in place
+ *
+ * @param[in] reader function lending the chunks
+ * @param[out] message deserialized message
+ * @throws std::runtime_error on error
+ */
+size_t deserialize(auto &message, spb::io::chunk_reader reader)
 {
     detail::istream_reader stream{reader};
     deserialize<detail::field_attributes{}>(stream, message);
@@ -124,9 +210,10 @@ size_t deserialize(auto &message, spb::io::reader reader)
  *          `auto message = Message();`
  *          `spb::json::deserialize(message, serialized);`
  */
-size_t deserialize(auto &message, const spb::size_container auto &json)
+size_t deserialize(auto &message, const spb::size_container auto &json,
+                   const deserialize_options &options = {})
 {
-    return deserialize(message, json.data(), json.size());
+    return deserialize(message, json.data(), json.size(), options);
 }
 
 /**
@@ -139,10 +226,12 @@ size_t deserialize(auto &message, const spb::size_container auto &json)
  * @example `auto serialized = std::vector< std::byte >( ... );`
  *          `auto message = spb::json::deserialize< Message >( serialized );`
  */
-template <typename Message> [[nodiscard]] Message deserialize(const spb::size_container auto &json)
+template <typename Message>
+[[nodiscard]] Message deserialize(const spb::size_container auto &json,
+                                  const deserialize_options &options = {})
 {
     auto message = Message{};
-    deserialize(message, json.data(), json.size());
+    deserialize(message, json.data(), json.size(), options);
     return message;
 }
 
@@ -154,10 +243,125 @@ template <typename Message> [[nodiscard]] Message deserialize(const spb::size_co
  * @return deserialized message
  * @throws std::runtime_error on error
  */
-template <typename Message> [[nodiscard]] Message deserialize(spb::io::reader reader)
+template <typename Message>
+[[nodiscard]] Message deserialize(spb::io::reader reader, const deserialize_options &options = {})
+{
+    auto message = Message{};
+    deserialize(message, reader, options);
+    return message;
+}
+
+/**
+ * @brief deserialize message from JSON lent in chunks by the reader, the chunks are parsed in place
+ *
+ * @param[in] reader function lending the chunks
+ * @return deserialized message
+ * @throws std::runtime_error on error
+ * @example `auto message = spb::json::deserialize< Message >( [&]{ return next_packet( ); } );`
+ */
+template <typename Message> [[nodiscard]] Message deserialize(spb::io::chunk_reader reader)
 {
     auto message = Message{};
     deserialize(message, reader);
     return message;
 }
+
+/**
+ * @brief deserialize message from reader, elements of arrays with a handler are passed one by one
+ *        to the handler and they are not stored in the message
+ *
+ * @param[in] reader function for handling reads
+ * @param[in] handlers handlers created by `spb::on_element`
+ * @return deserialized message (without the elements passed to handlers)
+ * @throws std::runtime_error on error
+ * @example `auto book = spb::json::deserialize_streaming<AddressBook>(reader,`
+ *          `    spb::on_element(&AddressBook::people, [](Person && person) { ... }));`
+ */
+template <typename Message>
+[[nodiscard]] Message deserialize_streaming(spb::io::reader reader, auto... handlers)
+{
+    auto message     = Message{};
+    const auto sinks = std::array<spb::detail::element_sink, sizeof...(handlers)>{
+        spb::detail::make_element_sink(message, handlers)...};
+    auto stream          = detail::istream_reader{reader};
+    stream.element_sinks = sinks;
+    deserialize<detail::field_attributes{}>(stream, message);
+    return message;
+}
+
+/**
+ * @brief deserialize message from JSON, elements of arrays with a handler are passed one by one
+ *        to the handler and they are not stored in the message
+ *
+ * @param[in] json serialized JSON
+ * @param[in] handlers handlers created by `spb::on_element`
+ * @return deserialized message (without the elements passed to handlers)
+ * @throws std::runtime_error on error
+ */
+template <typename Message>
+[[nodiscard]] Message deserialize_streaming(const spb::size_container auto &json, auto... handlers)
+{
+    auto message     = Message{};
+    const auto sinks = std::array<spb::detail::element_sink, sizeof...(handlers)>{
+        spb::detail::make_element_sink(message, handlers)...};
+    auto stream          = detail::istream_buffer{json.data(), json.size()};
+    stream.element_sinks = sinks;
+    deserialize<detail::field_attributes{}>(stream, message);
+    return message;
+}
+
+/**
+ * @brief deserialize elements of a top level JSON array (`[{...},{...}]`) or of newline delimited JSON
+ *        (`{...}\n{...}`) one by one, only the elements being passed to the callback are held in memory
+ *
+ * @param[in] reader function for handling reads
+ * @param[in] on_element called with `Message &&` for every element, or with `std::span< Message >` of up to
+ *            `batch_size` elements if it doesn't accept a single element
+ * @param[in] batch_size number of elements passed at once to a callback accepting `std::span< Message >`,
+ *            it has to be 1 for a callback accepting `Message &&`
+ * @return number of elements
+ * @throws std::runtime_error on error
+ * @throws std::invalid_argument for `batch_size` other than 1 with a callback accepting `Message &&`
+ * @example `spb::json::for_each< Person >( reader, []( Person && person ) { ... } );`
+ *          `spb::json::for_each< Person >( reader, []( std::span< Person > people ) { ... }, 1024 );`
+ */
+template <typename Message> size_t for_each(spb::io::reader reader, auto on_element, size_t batch_size = 1)
+{
+    auto stream = detail::istream_reader{reader};
+    return detail::for_each<Message>(stream, on_element, batch_size);
+}
+
+/**
+ * @brief deserialize elements of a top level JSON array or of newline delimited JSON one by one
+ *
+ * @param[in] json serialized JSON
+ * @param[in] on_element called with `Message &&` for every element, or with `std::span< Message >` of up to
+ *            `batch_size` elements if it doesn't accept a single element
+ * @param[in] batch_size number of elements passed at once to a callback accepting `std::span< Message >`,
+ *            it has to be 1 for a callback accepting `Message &&`
+ * @return number of elements
+ * @throws std::runtime_error on error
+ * @throws std::invalid_argument for `batch_size` other than 1 with a callback accepting `Message &&`
+ */
+template <typename Message>
+size_t for_each(const spb::size_container auto &json, auto on_element, size_t batch_size = 1)
+{
+    auto stream = detail::istream_buffer{json.data(), json.size()};
+    return detail::for_each<Message>(stream, on_element, batch_size);
+}
+
+/**
+ * @brief check that JSON is a valid `Message` without deserializing it (nothing is allocated)
+ *        checks syntax, `max_size` and `max_count` options, UTF-8 of strings, values of enums,
+ *        base64 of bytes and presence of required scalar fields
+ *
+ * @param[in] json serialized JSON
+ * @throws std::runtime_error if the JSON is not valid
+ * @example `spb::json::validate< Person >( json );`
+ */
+template <typename Message> void validate(const spb::size_container auto &json)
+{
+    auto stream = detail::istream_buffer{json.data(), json.size()};
+    detail::validate<detail::field_attributes{}, Message>(stream);
+}
 } // namespace spb::json
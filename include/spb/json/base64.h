@@ -11,8 +11,11 @@
 #pragma once
 
 #include "../concepts.h"
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <span>
 #include <stdexcept>
 
@@ -60,24 +63,26 @@ void base64_encode(auto &output, std::span<const std::byte> input)
     }
 }
 
+//- 128 for characters which are not base64
+static constexpr uint8_t base64_decode_table[256] = {
+    128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+    128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+    128, 128, 128, 62,  128, 128, 128, 63,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  128, 128,
+    128, 128, 128, 128, 128, 0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,
+    15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  128, 128, 128, 128, 128, 128, 26,  27,  28,
+    29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,
+    49,  50,  51,  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+    128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+    128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+    128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+    128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+    128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+    128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128};
+
 template <typename istream>
 void base64_decode_string(spb::detail::proto_field_bytes auto &output, istream &stream,
                           size_t max_output_size = 0)
 {
-    static constexpr uint8_t decode_table[256] = {
-        128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
-        128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
-        128, 128, 128, 62,  128, 128, 128, 63,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  128, 128,
-        128, 128, 128, 128, 128, 0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,
-        15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  128, 128, 128, 128, 128, 128, 26,  27,  28,
-        29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,
-        49,  50,  51,  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
-        128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
-        128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
-        128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
-        128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
-        128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
-        128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128};
 
     /*static constexpr uint8_t decode_table2[] = {
         62, 128, 128, 128, 63, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 128, 128, 128, 128, 128, 128,
@@ -133,10 +138,10 @@ void base64_decode_string(spb::detail::proto_field_bytes auto &output, istream &
 
             while (p_in < p_end) [[likely]]
             {
-                uint8_t v0 = decode_table[*p_in++];
-                uint8_t v1 = decode_table[*p_in++];
-                uint8_t v2 = decode_table[*p_in++];
-                uint8_t v3 = decode_table[*p_in++];
+                uint8_t v0 = base64_decode_table[*p_in++];
+                uint8_t v1 = base64_decode_table[*p_in++];
+                uint8_t v2 = base64_decode_table[*p_in++];
+                uint8_t v3 = base64_decode_table[*p_in++];
                 mask |= (v0 | v1 | v2 | v3);
 
                 *p_out++ = std::byte((v0 << 2) | (v1 >> 4));
@@ -155,12 +160,12 @@ void base64_decode_string(spb::detail::proto_field_bytes auto &output, istream &
             //- handle padding
             const auto *p_in = reinterpret_cast<const uint8_t *>(view.data());
 
-            uint8_t v0 = decode_table[*p_in++];
-            uint8_t v1 = decode_table[*p_in++];
+            uint8_t v0 = base64_decode_table[*p_in++];
+            uint8_t v1 = base64_decode_table[*p_in++];
             auto i1    = *p_in++;
-            uint8_t v2 = i1 == '=' ? 0 : decode_table[i1];
+            uint8_t v2 = i1 == '=' ? 0 : base64_decode_table[i1];
             auto i2    = *p_in++;
-            uint8_t v3 = i2 == '=' ? 0 : decode_table[i2];
+            uint8_t v3 = i2 == '=' ? 0 : base64_decode_table[i2];
             mask |= (v0 | v1 | v2 | v3);
             mask |= ((i1 == '=') & (i2 != '=')) ? 128 : 0;
             if (mask & 128) [[unlikely]]
@@ -170,6 +175,7 @@ void base64_decode_string(spb::detail::proto_field_bytes auto &output, istream &
             auto consumed_bytes = 3 - padding_size;
             //- +1 is for "
             stream.skip(5);
+            stream.skip_white_spaces();
             if constexpr (spb::detail::proto_field_bytes_resizable<decltype(output)>)
             {
                 if (max_output_size && (output.size() + consumed_bytes > max_output_size))
@@ -202,4 +208,122 @@ void base64_decode_string(spb::detail::proto_field_bytes auto &output, istream &
         }
     }
 }
+
+/**
+ * @brief decode JSON base64 string in chunks, the decoded bytes are passed to `on_chunk` as they arrive,
+ *        so the whole string is never kept in memory
+ *
+ * @param stream JSON stream at the opening '"'
+ * @param max_output_size maximal decoded size, 0 for unlimited
+ * @param on_chunk called with up to 3 KiB (4 KiB of base64) of decoded bytes
+ * @return decoded size in bytes
+ */
+auto base64_decode_chunks(auto &stream, size_t max_output_size, auto on_chunk) -> size_t
+{
+    if (!stream.consume('"')) [[unlikely]]
+        throw std::runtime_error("expecting '\"'");
+
+    std::byte buffer[3 * 1024];
+    auto buffered = size_t(0);
+    auto total    = size_t(0);
+    auto padded   = false;
+    while (!stream.consume('"'))
+    {
+        //- padding is allowed only in the last 4 chars
+        if (padded) [[unlikely]]
+            throw std::runtime_error("invalid base64");
+
+        //- at least 4 chars, shorter only at the end of the input
+        const auto view = stream.view(4, UINT32_MAX);
+        if (view.size() < 4) [[unlikely]]
+            throw std::runtime_error("invalid base64");
+
+        const auto *p_in  = reinterpret_cast<const uint8_t *>(view.data());
+        const auto quanta = std::min(view.size() / 4, (sizeof(buffer) - buffered) / 3);
+        auto consumed     = size_t(0);
+        while (consumed < quanta && !padded)
+        {
+            const auto i2 = p_in[2];
+            const auto i3 = p_in[3];
+            const auto v0 = base64_decode_table[p_in[0]];
+            const auto v1 = base64_decode_table[p_in[1]];
+            const auto v2 = i2 == '=' ? 0 : base64_decode_table[i2];
+            const auto v3 = i3 == '=' ? 0 : base64_decode_table[i3];
+            if (((v0 | v1 | v2 | v3) & 128) != 0 || (i2 == '=' && i3 != '=')) [[unlikely]]
+                throw std::runtime_error("invalid base64");
+
+            const auto size = size_t(3) - (i2 == '=' ? 1 : 0) - (i3 == '=' ? 1 : 0);
+            if (max_output_size && total + size > max_output_size) [[unlikely]]
+                throw std::length_error("bytes is too large");
+
+            const auto bytes = std::array{std::byte((v0 << 2) | (v1 >> 4)), std::byte((v1 << 4) | (v2 >> 2)),
+                                          std::byte((v2 << 6) | v3)};
+            memcpy(buffer + buffered, bytes.data(), size);
+            buffered += size;
+            total += size;
+            padded = size < 3;
+            p_in += 4;
+            consumed += 1;
+        }
+        stream.skip(consumed * 4);
+
+        if (sizeof(buffer) - buffered < 3)
+        {
+            on_chunk(std::span<const std::byte>(buffer, buffered));
+            buffered = 0;
+        }
+    }
+    if (buffered > 0)
+        on_chunk(std::span<const std::byte>(buffer, buffered));
+
+    stream.skip_white_spaces();
+    return total;
+}
+
+/**
+ * @brief check base64 string without decoding it
+ *
+ * @param stream JSON stream at the opening '"'
+ * @param max_output_size maximal decoded size, 0 for unlimited
+ * @return decoded size in bytes
+ */
+auto base64_validate_string(auto &stream, size_t max_output_size = 0) -> size_t
+{
+    if (!stream.consume('"')) [[unlikely]]
+        throw std::runtime_error("expecting '\"'");
+
+    if (stream.consume_and_skip_white_space('"'))
+        return 0;
+
+    const auto view   = stream.view(1, UINT32_MAX);
+    const auto length = view.find('"');
+    if (length == view.npos || length % 4 != 0) [[unlikely]]
+        throw std::runtime_error("invalid base64");
+
+    auto padding_size = size_t(0);
+    for (size_t i = 0; i < length; ++i)
+    {
+        const auto c = view[i];
+        //- '=' is allowed only in the last 2 chars
+        if (c == '=' && i + 2 >= length)
+        {
+            padding_size += 1;
+            continue;
+        }
+
+        const auto is_base64 = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                               c == '+' || c == '/';
+        if (!is_base64 || padding_size > 0) [[unlikely]]
+            throw std::runtime_error("invalid base64");
+    }
+
+    const auto output_size = (length / 4) * 3 - padding_size;
+    if (max_output_size && output_size > max_output_size) [[unlikely]]
+        throw std::length_error("bytes is too large");
+
+    //- +1 is for "
+    stream.skip(length + 1);
+    stream.skip_white_spaces();
+    return output_size;
+}
 } // namespace spb::json::detail
@@ -12,11 +12,16 @@
 
 #include "../bits.h"
 #include "../concepts.h"
+#include "../streaming.hpp"
 #include "../to_from_chars.h"
 #include "../utf8.h"
 #include "base64.h"
+#include "escape.h"
 #include "field.hpp"
+#include "structural-index.h"
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cctype>
 #include <cstddef>
 #include <cstdint>
@@ -24,11 +29,13 @@
 #include <memory>
 #include <spb/io/buffer-io.hpp>
 #include <spb/io/io.hpp>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <variant>
+#include <vector>
 
 namespace spb::json::detail
 {
@@ -67,6 +74,34 @@ static constexpr inline auto djb2_hash(std::string_view str) noexcept -> uint32_
     return hash;
 }
 
+/**
+ * @brief hash of a key for the generated key dispatch, mixes key's size with its first and last 8 bytes
+ *        (all bytes of keys up to 16 bytes), sprotoc picks `seed` which makes it collision-free for all
+ *        keys of a message
+ *
+ * @param str key
+ * @param seed picked by sprotoc
+ * @return uint32_t
+ */
+static constexpr inline auto key_hash(std::string_view str, uint32_t seed) noexcept -> uint32_t
+{
+    //- little endian load, compilers turn the loop into a single load for 8 bytes
+    const auto load = [](const char *p, size_t size) noexcept
+    {
+        auto value = uint64_t(0);
+        for (size_t i = 0; i < size; ++i)
+            value |= uint64_t(uint8_t(p[i])) << (8U * i);
+        return value;
+    };
+    const auto size  = str.size();
+    const auto front = size >= 8 ? load(str.data(), 8) : load(str.data(), size);
+    const auto back  = size > 8 ? load(str.data() + size - 8, 8) : 0;
+    //- odd multiplier for every seed
+    const auto multiplier = 0x9E3779B97F4A7C15ULL + ((uint64_t(seed) * 0xD6E8FEB86659FD93ULL) << 1U);
+    const auto mixed      = (front ^ std::rotl(back, 29) ^ size) * multiplier;
+    return uint32_t(mixed ^ (mixed >> 32U));
+}
+
 static constexpr inline auto fnv1a_hash(std::string_view str) noexcept -> uint64_t
 {
     uint64_t hash        = 14695981039346656037ULL;
@@ -93,10 +128,31 @@ template <spb::detail::proto_field_bytes T> void clear(T &container)
     }
 }
 
+/**
+ * @brief offset of the first '"' or '\' in `view`, `view.npos` if there is none
+ *        the leading run of printable characters is skipped 16 bytes at once (see `safe_prefix_size`)
+ */
+inline auto quote_or_backslash_offset(std::string_view view) noexcept -> size_t
+{
+    const auto plain = safe_prefix_size<false>(view.data(), view.data() + view.size());
+    return view.find_first_of(R"("\)", plain);
+}
+
 struct istream_buffer
 {
+    //- the whole input is in memory, views into it stay valid while parsing
+    static constexpr bool contiguous = true;
+
     const uint8_t *p_start;
     const uint8_t *p_end;
+    //- index of the key expected next in the current object (see `consume_expected_key`)
+    size_t next_key = 0;
+    //- handlers for elements of repeated fields (see `deserialize_streaming`)
+    std::span<const spb::detail::element_sink> element_sinks;
+    //- start of the input and the next of its token starts (see `build_structural_index`),
+    //- nullptr if the input is not indexed
+    const uint8_t *p_base   = nullptr;
+    const uint32_t *p_token = nullptr;
 
     istream_buffer(const void *start, const void *end) noexcept
         : p_start((uint8_t *)start), p_end((uint8_t *)end)
@@ -151,19 +207,12 @@ struct istream_buffer
             return true;
 
         const auto char_behind_token = p_start[token.size()];
-        if (!isalnum(char_behind_token) && char_behind_token != '_')
-        {
-            skip(token.size());
-            return true;
-        }
+        if (isalnum(char_behind_token) || char_behind_token == '_')
+            return false;
 
-        if (isspace(char_behind_token))
-        {
-            skip(token.size());
-            skip_white_spaces();
-            return true;
-        }
-        return false;
+        skip(token.size());
+        skip_white_spaces();
+        return true;
     }
     [[nodiscard]] int current_char() const
     {
@@ -171,11 +220,44 @@ struct istream_buffer
     }
     void skip_white_spaces() noexcept
     {
+        if (p_token != nullptr && !empty() && isspace(*p_start))
+        {
+            //- white spaces run up to the next token (never called inside of a string)
+            p_start = next_token();
+            return;
+        }
         while (!empty() && isspace(*p_start))
         {
             ++p_start;
         }
     }
+    /**
+     * @brief offset of the first '"' or '\' in `view` (of the current position), `view.npos` if there is none
+     *        indexed input knows where the string ends, so only the backslash is searched for
+     */
+    [[nodiscard]] auto find_quote_or_backslash(std::string_view view) noexcept -> size_t
+    {
+        if (p_token == nullptr)
+            return quote_or_backslash_offset(view);
+
+        //- inside of a string the next token is its closing quote
+        const auto quote = std::min<size_t>(next_token() - p_start, view.size());
+        if (const auto *p_backslash = memchr(view.data(), '\\', quote); p_backslash != nullptr)
+            return static_cast<const char *>(p_backslash) - view.data();
+
+        return quote < view.size() ? quote : view.npos;
+    }
+    /**
+     * @brief first token start at or behind the current position (indexed input only)
+     */
+    [[nodiscard]] auto next_token() noexcept -> const uint8_t *
+    {
+        const auto offset = uint32_t(p_start - p_base);
+        while (*p_token < offset)
+            ++p_token;
+
+        return p_base + *p_token;
+    }
     void consume_current_char(bool skip_white_space)
     {
         if (empty()) [[unlikely]]
@@ -208,7 +290,19 @@ struct istream_reader
     }
 
   public:
-    istream_reader(spb::io::reader reader) : reader(reader)
+    //- index of the key expected next in the current object (see `consume_expected_key`)
+    size_t next_key = 0;
+    //- handlers for elements of repeated fields (see `deserialize_streaming`)
+    std::span<const spb::detail::element_sink> element_sinks;
+
+    istream_reader(spb::io::reader reader, size_t buffer_size = spb::io::buffered_reader::DEFAULT_BUFFER_SIZE)
+        : reader(reader, buffer_size)
+    {
+    }
+    istream_reader(spb::io::reader reader, std::span<char> buffer) : reader(reader, buffer)
+    {
+    }
+    istream_reader(spb::io::chunk_reader reader) : reader(reader)
     {
     }
 
@@ -217,6 +311,11 @@ struct istream_reader
         return m_consumed_size;
     }
 
+    [[nodiscard]] auto empty() -> bool
+    {
+        return reader.view(1).empty();
+    }
+
     [[nodiscard]] auto current_char() -> char
     {
         auto view = reader.view(1);
@@ -255,20 +354,13 @@ struct istream_reader
         if (token_view.size() == token.size()) [[unlikely]]
             return true;
 
-        const auto char_behind_token = token_view.back();
-        if (!isalnum(char_behind_token) && char_behind_token != '_')
-        {
-            skip(token.size());
-            return true;
-        }
+        const auto char_behind_token = token_view[token.size()];
+        if (isalnum(char_behind_token) || char_behind_token == '_')
+            return false;
 
-        if (isspace(char_behind_token))
-        {
-            skip(token.size());
-            skip_white_spaces();
-            return true;
-        }
-        return false;
+        skip(token.size());
+        skip_white_spaces();
+        return true;
     }
 
     void skip_white_spaces()
@@ -293,9 +385,17 @@ struct istream_reader
         }
     }
 
+    [[nodiscard]] auto find_quote_or_backslash(std::string_view view) const noexcept -> size_t
+    {
+        return quote_or_backslash_offset(view);
+    }
+
     [[nodiscard]] auto view(size_t min_size, size_t max_size) -> std::string_view
     {
-        auto result = reader.view(max_size);
+        //- buffered data are returned as they are, the reader is asked for more only if there is less than
+        //- `max_size` (up to the buffer's guaranteed size), so the input is not moved around on every call
+        constexpr auto guaranteed_size = spb::io::buffered_reader::MIN_BUFFER_SIZE;
+        auto result = reader.view(std::max(min_size, std::min(max_size, guaranteed_size)));
         if (result.size() < min_size) [[unlikely]]
             throw std::runtime_error("unexpected end of stream");
 
@@ -333,7 +433,7 @@ void ignore_string_until_double_quota(auto &stream)
     for (;;)
     {
         auto view = stream.view(1, UINT32_MAX);
-        auto pos  = view.find_first_of(R"(\")");
+        auto pos  = stream.find_quote_or_backslash(view);
         if (pos == view.npos)
         {
             stream.skip(view.size());
@@ -366,10 +466,22 @@ void ignore_string(auto &stream)
     ignore_string_until_double_quota(stream);
 }
 
+/**
+ * @brief input stream with the whole input in memory (keys can be used in place, without a copy)
+ */
+template <typename Stream>
+concept contiguous_stream = std::remove_cvref_t<Stream>::contiguous;
+
+/**
+ * @brief read JSON string without escapes of size `min_size`..`max_size`, longer (or escaped) strings are
+ *        skipped and an empty view is returned
+ *
+ * @param buffer storage for the string (at least `max_size`), not used for `contiguous_stream`
+ */
 auto deserialize_string_to_buffer(auto &stream, size_t min_size, size_t max_size, char *buffer)
     -> std::string_view
 {
-    assert(max_size < io::buffered_reader::BUFFER_SIZE);
+    assert(max_size < io::buffered_reader::MIN_BUFFER_SIZE);
 
     if (!stream.consume('"')) [[unlikely]]
         throw std::runtime_error(R"(expecting '"')");
@@ -379,8 +491,11 @@ auto deserialize_string_to_buffer(auto &stream, size_t min_size, size_t max_size
     size_t start = 0;
     for (;;)
     {
-        const auto pos = view.find_first_of(R"(\")", start);
-        if (pos == view.npos) [[unlikely]]
+        //- vectorized scan for the next '"' or '\' (or a control character)
+        const auto *p_end  = view.data() + view.size();
+        const auto *p_next = view.data() + std::min(start, view.size());
+        const auto pos     = size_t(p_next - view.data()) + safe_prefix_size<false>(p_next, p_end);
+        if (pos == view.size()) [[unlikely]]
         {
             stream.skip(view.size());
             break;
@@ -388,15 +503,19 @@ auto deserialize_string_to_buffer(auto &stream, size_t min_size, size_t max_size
 
         if (view[pos] == '"') [[likely]]
         {
-            memcpy(buffer, view.data(), pos);
+            //- contiguous input outlives the key, so it is not copied
+            const auto *p_key = view.data();
+            if constexpr (!contiguous_stream<decltype(stream)>)
+                p_key = static_cast<const char *>(memcpy(buffer, view.data(), pos));
+
             // +1 for '""
             stream.skip(pos + 1);
             stream.skip_white_spaces();
-            return (pos >= min_size) ? std::string_view{buffer, pos} : std::string_view{};
+            return (pos >= min_size) ? std::string_view{p_key, pos} : std::string_view{};
         }
 
-        // +2 for \ and char behind
-        start = pos + 2;
+        // +2 for \ and char behind, +1 for a control character
+        start = pos + (view[pos] == '\\' ? 2 : 1);
     }
     ignore_string_until_double_quota(stream);
     return {};
@@ -474,16 +593,12 @@ auto unescape(auto &stream, char utf8[4]) -> uint32_t
     }
 }
 
+/**
+ * @brief read the rest of a JSON string (behind the opening quote) and append it to `value`
+ */
 template <field_attributes attributes>
-void deserialize(auto &stream, spb::detail::proto_field_string auto &value)
+void deserialize_string_content(auto &stream, spb::detail::proto_field_string auto &value)
 {
-    if (!stream.consume('"')) [[unlikely]]
-        throw std::runtime_error(R"(expecting '"')");
-
-    if constexpr (spb::detail::proto_field_string_resizable<decltype(value)>)
-    {
-        value.clear();
-    }
     auto index           = size_t(0);
     auto append_to_value = [&](const char *str, size_t size)
     {
@@ -511,7 +626,7 @@ void deserialize(auto &stream, spb::detail::proto_field_string auto &value)
     for (;;)
     {
         auto view  = stream.view(1, UINT32_MAX);
-        auto found = view.find_first_of(R"("\)");
+        auto found = stream.find_quote_or_backslash(view);
         if (found == view.npos) [[unlikely]]
         {
             append_to_value(view.data(), view.size());
@@ -529,13 +644,80 @@ void deserialize(auto &stream, spb::detail::proto_field_string auto &value)
                 if (index != value.size()) [[unlikely]]
                     throw std::runtime_error("invalid string size");
             }
-            return;
+            break;
         }
         char utf8_buffer[4];
         auto utf8_size = unescape(stream, utf8_buffer);
         append_to_value(utf8_buffer, utf8_size);
     }
     spb::detail::utf8::validate(std::string_view(value.data(), value.size()));
+    stream.skip_white_spaces();
+}
+
+template <field_attributes attributes>
+void deserialize(auto &stream, spb::detail::proto_field_string auto &value)
+{
+    if (!stream.consume('"')) [[unlikely]]
+        throw std::runtime_error(R"(expecting '"')");
+
+    if constexpr (spb::detail::proto_field_string_resizable<decltype(value)>)
+    {
+        value.clear();
+    }
+    deserialize_string_content<attributes>(stream, value);
+}
+
+/**
+ * @brief string without escapes is pointed into a contiguous input (zero-copy), anything else is copied
+ *        into an owning view (`spb::json_string`), a plain `std::string_view` rejects escaped strings
+ *        (and a reader at compile time)
+ */
+template <field_attributes attributes>
+void deserialize(auto &stream, spb::detail::proto_field_string_view auto &value)
+{
+    constexpr auto owning = spb::detail::proto_field_string_view_owning<decltype(value)>;
+
+    if constexpr (contiguous_stream<decltype(stream)>)
+    {
+        if (!stream.consume('"')) [[unlikely]]
+            throw std::runtime_error(R"(expecting '"')");
+
+        const auto view  = stream.view(1, UINT32_MAX);
+        const auto found = stream.find_quote_or_backslash(view);
+        if (found != view.npos && view[found] == '"') [[likely]]
+        {
+            const auto str = view.substr(0, found);
+            if constexpr (attributes.max_size)
+                check_size(str.size(), attributes.max_size);
+
+            spb::detail::utf8::validate(str);
+            value = str;
+            stream.skip(found + 1);
+            stream.skip_white_spaces();
+            return;
+        }
+        if constexpr (owning)
+        {
+            //- the content is scanned again from its start, only escaped strings pay for it
+            auto owned = std::string();
+            deserialize_string_content<attributes>(stream, owned);
+            value.own(std::move(owned));
+        }
+        else
+        {
+            throw std::runtime_error("escaped string can't be borrowed");
+        }
+    }
+    else if constexpr (owning)
+    {
+        auto owned = std::string();
+        deserialize<attributes>(stream, owned);
+        value.own(std::move(owned));
+    }
+    else
+    {
+        static_assert(owning, "std::string_view needs a contiguous input, use spb::json_string for a reader");
+    }
 }
 
 template <field_attributes> void deserialize(auto &stream, spb::detail::proto_field_int_or_float auto &value)
@@ -558,6 +740,7 @@ template <field_attributes> void deserialize(auto &stream, spb::detail::proto_fi
         throw std::runtime_error("invalid number");
 
     stream.skip(result.ptr - view.data());
+    stream.skip_white_spaces();
 }
 
 template <field_attributes> void deserialize(auto &stream, bool &value)
@@ -612,6 +795,9 @@ void deserialize(auto &stream, Container &value)
         {
             deserialize<attributes>(stream, value.emplace_back());
         }
+
+        if (!stream.element_sinks.empty()) [[unlikely]]
+            spb::detail::flush_elements(stream.element_sinks, &value);
     } while (stream.consume_and_skip_white_space(','));
 
     if (!stream.consume_and_skip_white_space(']')) [[unlikely]]
@@ -662,9 +848,41 @@ void deserialize(auto &stream, spb::detail::proto_field_bytes auto &value)
     base64_decode_string(value, stream, attributes.max_size);
 }
 
+template <field_attributes attributes>
+void deserialize(auto &stream, spb::detail::proto_field_raw auto &value)
+{
+    if (stream.consume_and_skip_white_space("null"sv))
+    {
+        value.clear();
+        return;
+    }
+
+    //- json has no raw form of a sub-message, so it has to be encoded
+    auto message = typename std::decay_t<decltype(value)>::message_type();
+    deserialize<attributes>(stream, message);
+    value.encode(message);
+}
+
+template <field_attributes attributes>
+void deserialize(auto &stream, spb::detail::proto_cached auto &value)
+{
+    deserialize<attributes>(stream, value.mutable_value());
+}
+
+template <field_attributes attributes>
+void deserialize(auto &stream, spb::detail::proto_field_stream_bytes auto &value)
+{
+    if (stream.consume_and_skip_white_space("null"sv))
+        return;
+
+    //- base64 is decoded in chunks and passed to the sink as they arrive
+    base64_decode_chunks(stream, attributes.max_size,
+                         [&](std::span<const std::byte> chunk) { value.push(chunk); });
+}
+
 template <field_attributes attributes, typename T> void deserialize_map_key(auto &stream, T &map_key)
 {
-    if constexpr (std::is_same_v<T, std::string>)
+    if constexpr (spb::detail::proto_field_string<T>)
     {
         deserialize<attributes>(stream, map_key);
     }
@@ -847,14 +1065,30 @@ void deserialize_variant(auto &stream, T &variant)
     deserialize<attributes>(stream, variant.template emplace<ordinal>());
 }
 
+/**
+ * @brief false for messages with `std::string_view` fields and a reader, the generated
+ *        `deserialize_value` is deleted for them
+ */
+template <typename Stream, typename Message>
+concept message_deserializable =
+    requires(std::remove_cvref_t<Stream> &stream, std::remove_cvref_t<Message> &message) {
+    deserialize_value(stream, message);
+};
+
 template <field_attributes> void deserialize(auto &stream, spb::detail::proto_message auto &value)
 {
+    static_assert(message_deserializable<decltype(stream), decltype(value)>,
+                  "std::string_view fields need a contiguous input, use spb::json_string for a reader");
+
     if (!stream.consume_and_skip_white_space('{')) [[unlikely]]
         throw std::runtime_error("expecting '{'");
 
     if (stream.consume_and_skip_white_space('}'))
         return;
 
+    //- keys are expected from the 1st field, the parent's expected key is restored afterwards
+    const auto parent_key = stream.next_key;
+    stream.next_key       = 0;
     for (;;)
     {
         //- generated by the sprotoc
@@ -864,10 +1098,34 @@ template <field_attributes> void deserialize(auto &stream, spb::detail::proto_me
             continue;
 
         if (stream.consume_and_skip_white_space('}'))
-            return;
+            break;
 
         throw std::runtime_error("expecting '}' or ','");
     }
+    stream.next_key = parent_key;
+}
+
+/**
+ * @brief consume the key `keys[stream.next_key]` (with `:`) if it is the next one in the input,
+ *        keys are expected in the order `serialize` writes them, so machine generated JSON is matched
+ *        by a single compare
+ *
+ * @param keys quoted keys of a message (`"name":`)
+ * @return index of the consumed key, `keys.size()` if it was not the expected one (nothing is consumed)
+ */
+template <size_t N>
+auto consume_expected_key(auto &stream, const std::array<std::string_view, N> &keys) -> size_t
+{
+    if (stream.next_key >= N) [[unlikely]]
+        return N;
+
+    const auto key = keys[stream.next_key];
+    if (stream.view(1, key.size()) != key)
+        return N;
+
+    stream.skip(key.size());
+    stream.skip_white_spaces();
+    return stream.next_key++;
 }
 
 auto deserialize_key(auto &stream, size_t min_size, size_t max_size, char *buffer) -> std::string_view
@@ -895,9 +1153,284 @@ auto deserialize_int(auto &stream) -> int32_t
     return result;
 }
 
+/**
+ * @brief JSON number grammar `-?digits(.digits)?([eE][+-]?digits)?` checked one character at a time,
+ *        so a number can span more views of a buffered input
+ */
+struct number_skipper
+{
+    enum class state : uint8_t
+    {
+        sign,
+        integer,
+        dot,
+        fraction,
+        exponent,
+        exponent_sign,
+        exponent_digits,
+    };
+    state current = state::sign;
+
+    static constexpr auto is_digit(char c) noexcept -> bool
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    /**
+     * @return false for the first character after the number
+     */
+    constexpr auto feed(char c) noexcept -> bool
+    {
+        const auto digit = is_digit(c);
+        switch (current)
+        {
+        case state::sign:
+        case state::integer:
+            if (digit)
+                current = state::integer;
+            else if (current == state::integer && c == '.')
+                current = state::dot;
+            else if (current == state::integer && (c == 'e' || c == 'E'))
+                current = state::exponent;
+            else
+                return false;
+            return true;
+        case state::dot:
+        case state::fraction:
+            if (digit)
+                current = state::fraction;
+            else if (current == state::fraction && (c == 'e' || c == 'E'))
+                current = state::exponent;
+            else
+                return false;
+            return true;
+        case state::exponent:
+            if (c == '+' || c == '-')
+            {
+                current = state::exponent_sign;
+                return true;
+            }
+            [[fallthrough]];
+        case state::exponent_sign:
+        case state::exponent_digits:
+            if (!digit)
+                return false;
+            current = state::exponent_digits;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief true if the number can end here (`-`, `1.` and `1e` can't)
+     */
+    [[nodiscard]] constexpr auto complete() const noexcept -> bool
+    {
+        return current == state::integer || current == state::fraction || current == state::exponent_digits;
+    }
+};
+
+/**
+ * @brief skip a number, `true`, `false` or `null`, numbers are not converted (only their syntax checked)
+ */
+void skip_literal(auto &stream)
+{
+    const auto c = stream.current_char();
+    if (c == 't' || c == 'f' || c == 'n')
+    {
+        for (auto literal : std::array{"true"sv, "false"sv, "null"sv})
+        {
+            if (stream.consume_and_skip_white_space(literal))
+                return;
+        }
+        throw std::runtime_error("invalid value");
+    }
+    if (c != '-' && !number_skipper::is_digit(c)) [[unlikely]]
+        throw std::runtime_error("invalid value");
+
+    auto skipper = number_skipper{};
+    if (c == '-')
+        stream.skip(1);
+    for (;;)
+    {
+        const auto view   = stream.view(1, UINT32_MAX);
+        const auto length = size_t(std::find_if_not(view.begin(), view.end(),
+                                                     [&skipper](char ch) { return skipper.feed(ch); }) -
+                                   view.begin());
+        stream.skip(length);
+        if (length < view.size())
+        {
+            //- `1.2.3`, `1e+-2` or `--1` would be left as a number for the next token
+            const auto next = view[length];
+            if (!skipper.complete() || number_skipper::is_digit(next) || next == '.' || next == '-' ||
+                next == '+' || next == 'e' || next == 'E') [[unlikely]]
+                throw std::runtime_error("invalid number");
+            break;
+        }
+    }
+    stream.skip_white_spaces();
+}
+
+/**
+ * @brief skip an object or an array by walking the bracket tokens of the structural index
+ */
+inline void skip_nested_indexed(istream_buffer &stream)
+{
+    auto depth = size_t(0);
+    for (const auto *p_token = stream.next_token();; p_token = stream.p_base + *++stream.p_token)
+    {
+        if (p_token >= stream.p_end) [[unlikely]]
+            throw std::runtime_error("unexpected end of stream");
+
+        if (*p_token == '{' || *p_token == '[')
+        {
+            ++depth;
+        }
+        else if ((*p_token == '}' || *p_token == ']') && --depth == 0)
+        {
+            stream.skip(p_token + 1 - stream.p_start);
+            stream.skip_white_spaces();
+            return;
+        }
+    }
+}
+
+/**
+ * @brief skip an object or an array, 64 bytes blocks are scanned for strings and brackets at once
+ */
+void skip_nested(auto &stream)
+{
+    if constexpr (contiguous_stream<decltype(stream)>)
+    {
+        if (stream.p_token != nullptr)
+            return skip_nested_indexed(stream);
+    }
+
+    auto skipper = nested_skipper{};
+    for (;;)
+    {
+        const auto view = stream.view(1, UINT32_MAX);
+        auto offset     = size_t(0);
+        for (; view.size() - offset >= 64; offset += 64)
+        {
+            if (const auto end = skipper.feed(view.data() + offset); end < 64)
+            {
+                stream.skip(offset + end + 1);
+                stream.skip_white_spaces();
+                return;
+            }
+        }
+        if (offset == 0)
+        {
+            //- views are shorter than `buffered_reader::MIN_BUFFER_SIZE` only at the end of the input
+            char block[64];
+            memset(block, ' ', sizeof(block));
+            memcpy(block, view.data(), view.size());
+            if (const auto end = skipper.feed(block); end < view.size())
+            {
+                stream.skip(end + 1);
+                stream.skip_white_spaces();
+                return;
+            }
+            throw std::runtime_error("unexpected end of stream");
+        }
+        //- the state is carried over, the rest of the view is refilled
+        stream.skip(offset);
+    }
+}
+
+/**
+ * @brief skip the value of an unknown key, only strings and brackets are tracked and literals are not
+ *        converted, `ignore_value` checks the full syntax
+ */
 void skip_value(auto &stream)
 {
-    ignore_value(stream);
+    switch (stream.current_char())
+    {
+    case '{':
+    case '[':
+        return skip_nested(stream);
+    case '"':
+        return ignore_string(stream);
+    default:
+        return skip_literal(stream);
+    }
+}
+
+/**
+ * @brief deserialize elements of a top level JSON array or of newline delimited JSON one by one
+ *
+ * @param on_element called with `Message &&` for every element, or with `std::span<Message>` of up to
+ *        `batch_size` elements if it does not accept a single element
+ * @param batch_size has to be 1 for a callback accepting `Message &&`
+ * @return number of elements
+ * @throws std::invalid_argument for `batch_size` other than 1 with a callback accepting `Message &&`
+ */
+template <typename Message> auto for_each(auto &stream, auto &on_element, size_t batch_size) -> size_t
+{
+    constexpr auto one_by_one = std::is_invocable_v<decltype(on_element) &, Message &&>;
+
+    if constexpr (one_by_one)
+    {
+        if (batch_size != 1) [[unlikely]]
+            throw std::invalid_argument("batch_size needs a callback accepting std::span");
+    }
+    batch_size = std::max<size_t>(batch_size, 1);
+
+    auto count   = size_t(0);
+    auto element = Message{};
+    auto batch   = std::vector<Message>();
+    if constexpr (!one_by_one)
+        batch.reserve(batch_size);
+
+    const auto next_element = [&]
+    {
+        if constexpr (one_by_one)
+        {
+            element = Message{};
+            deserialize<field_attributes{}>(stream, element);
+            on_element(std::move(element));
+        }
+        else
+        {
+            deserialize<field_attributes{}>(stream, batch.emplace_back());
+            //- capacity can be larger than reserved, so it can't be used as the batch size
+            if (batch.size() >= batch_size)
+            {
+                on_element(std::span<Message>(batch));
+                batch.clear();
+            }
+        }
+        count += 1;
+    };
+
+    stream.skip_white_spaces();
+    if (stream.consume_and_skip_white_space('['))
+    {
+        if (!stream.consume_and_skip_white_space(']'))
+        {
+            do
+            {
+                next_element();
+            } while (stream.consume_and_skip_white_space(','));
+
+            if (!stream.consume_and_skip_white_space(']')) [[unlikely]]
+                throw std::runtime_error("expecting ']'");
+        }
+    }
+    else
+    {
+        //- one value per line, new lines are white spaces skipped behind every value
+        while (!stream.empty())
+            next_element();
+    }
+
+    if constexpr (!one_by_one)
+    {
+        if (!batch.empty())
+            on_element(std::span<Message>(batch));
+    }
+    return count;
 }
 
 } // namespace spb::json::detail
@@ -0,0 +1,126 @@
+/***************************************************************************\
+* Name        : json escape                                                 *
+* Description : vectorized scan for characters which need JSON escaping     *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPB_JSON_ESCAPE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SPB_JSON_ESCAPE_NEON 1
+#endif
+
+namespace spb::json::detail
+{
+/**
+ * @brief escape of an ASCII character, 0 - no escape, 'u' - `\u00XX`, otherwise the character after `\`
+ */
+static constexpr auto escape_table = []
+{
+    auto table = std::array<char, 128>{};
+    for (auto c = 0; c < 0x20; c++)
+        table[c] = 'u';
+
+    table['"']  = '"';
+    table['\\'] = '\\';
+    table['\b'] = 'b';
+    table['\f'] = 'f';
+    table['\n'] = 'n';
+    table['\r'] = 'r';
+    table['\t'] = 't';
+    return table;
+}();
+
+/**
+ * @param escape_unicode non ASCII (>= 0x80) needs escaping (`\uXXXX`) too
+ */
+template <bool escape_unicode = true> static constexpr auto is_escape(uint8_t c) -> bool
+{
+    return c >= 0x80 ? escape_unicode : escape_table[c] != 0;
+}
+
+/**
+ * @brief size of the leading run of bytes which can be copied as they are
+ *        (printable ASCII except `"` and `\`), 16 (SSE2/NEON) or 8 (SWAR) bytes are checked at once
+ *
+ * @param escape_unicode non ASCII (>= 0x80) needs escaping (`\uXXXX`) too
+ */
+template <bool escape_unicode = true>
+inline auto safe_prefix_size(const char *p_start, const char *p_end) noexcept -> size_t
+{
+    const auto *p = p_start;
+
+#if defined(SPB_JSON_ESCAPE_SSE2)
+    const auto quote     = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto space     = _mm_set1_epi8(' ');
+    for (; p_end - p >= 16; p += 16)
+    {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        //- signed compare, so bytes >= 0x80 are also "less than space"
+        const auto special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        auto escape        = _mm_or_si128(_mm_cmplt_epi8(chunk, space), special);
+        if constexpr (!escape_unicode)
+            escape = _mm_andnot_si128(_mm_cmplt_epi8(chunk, _mm_setzero_si128()), escape);
+
+        if (const auto mask = uint32_t(_mm_movemask_epi8(escape)); mask != 0)
+            return (p - p_start) + std::countr_zero(mask);
+    }
+#elif defined(SPB_JSON_ESCAPE_NEON)
+    const auto quote     = vdupq_n_u8('"');
+    const auto backslash = vdupq_n_u8('\\');
+    const auto space     = vdupq_n_u8(' ');
+    const auto ascii     = vdupq_n_u8(0x80);
+    for (; p_end - p >= 16; p += 16)
+    {
+        const auto chunk   = vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+        const auto special = vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash));
+        auto escape        = vorrq_u8(vcltq_u8(chunk, space), special);
+        if constexpr (escape_unicode)
+            escape = vorrq_u8(escape, vcgeq_u8(chunk, ascii));
+
+        if (vmaxvq_u8(escape) != 0)
+            break;
+    }
+#else
+    constexpr auto ones = uint64_t(0x0101010101010101ULL);
+    constexpr auto high = uint64_t(0x8080808080808080ULL);
+    for (; p_end - p >= 8; p += 8)
+    {
+        auto word = uint64_t(0);
+        memcpy(&word, p, sizeof(word));
+        const auto quote     = word ^ (ones * '"');
+        const auto backslash = word ^ (ones * '\\');
+        //- high bit is set for bytes < 0x20, == '"', == '\\' (and >= 0x80),
+        //- false positives (caused by borrows) are sorted out by the byte loop below
+        auto escape =
+            ((word - ones * ' ') & ~word) | ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash);
+        if constexpr (escape_unicode)
+            escape |= word;
+
+        if ((escape & high) != 0)
+            break;
+    }
+#endif
+    for (; p < p_end; ++p)
+    {
+        if (is_escape<escape_unicode>(uint8_t(*p)))
+            break;
+    }
+    return p - p_start;
+}
+
+} // namespace spb::json::detail
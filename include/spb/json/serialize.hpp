@@ -11,15 +11,16 @@
 #pragma once
 
 #include "../concepts.h"
+#include "../field_mask.hpp"
 
 #include "../to_from_chars.h"
 #include "base64.h"
+#include "escape.h"
 #include "field.hpp"
 #include "spb/utf8.h"
 #include <algorithm>
 #include <array>
 #include <charconv>
-#include <cinttypes>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -37,7 +38,11 @@ struct ostream_size
 {
     static constexpr bool size_only = true;
     size_t size;
-    bool put_comma = false;
+    bool put_comma                = false;
+    //- non ASCII characters are written as `\uXXXX`, otherwise as they are (UTF-8)
+    bool escape_unicode           = true;
+    //- selected fields of the message being serialized, nullptr for all fields
+    const spb::field_mask *p_mask = nullptr;
 
     void write(uint8_t) noexcept
     {
@@ -55,7 +60,9 @@ struct ostream_buffer
     static constexpr bool size_only = false;
 
     uint8_t *p_buffer;
-    bool put_comma = false;
+    bool put_comma                = false;
+    bool escape_unicode           = true;
+    const spb::field_mask *p_mask = nullptr;
 
     explicit ostream_buffer(void *buffer) : p_buffer((std::uint8_t *)buffer)
     {
@@ -77,8 +84,10 @@ struct ostream_writer
 {
     static constexpr bool size_only = false;
     spb::io::writer on_write;
-    size_t size    = 0;
-    bool put_comma = false;
+    size_t size                   = 0;
+    bool put_comma                = false;
+    bool escape_unicode           = true;
+    const spb::field_mask *p_mask = nullptr;
 
     explicit ostream_writer(spb::io::writer writer) : on_write(writer)
     {
@@ -96,25 +105,108 @@ struct ostream_writer
     }
 };
 
-template <field_attributes = field_attributes{}> size_t serialize_size(const auto &value);
+/**
+ * @brief output stream into a resizable container, the container grows geometrically (amortized)
+ *        so the message is formatted only once (no `serialize_size` pass)
+ */
+struct ostream_growable
+{
+    static constexpr bool size_only = false;
+
+    uint8_t *p_start              = nullptr;
+    uint8_t *p_buffer             = nullptr;
+    uint8_t *p_end                = nullptr;
+    bool put_comma                = false;
+    bool escape_unicode           = true;
+    const spb::field_mask *p_mask = nullptr;
+    //- type erased container, `p_resize` resizes it and returns its data
+    void *p_container;
+    uint8_t *(*p_resize)(void *p_container, size_t size);
+
+    template <spb::resizable_container Container>
+    explicit ostream_growable(Container &container) : p_container(&container), p_resize(&resize<Container>)
+    {
+        //- reuse the whole capacity of the container, if it has one
+        if constexpr (requires { container.capacity(); })
+        {
+            p_start  = resize<Container>(p_container, container.capacity());
+            p_buffer = p_start;
+            p_end    = p_start + container.size();
+        }
+    }
+
+    template <spb::resizable_container Container> static uint8_t *resize(void *p_container, size_t size)
+    {
+        auto &container = *static_cast<Container *>(p_container);
+        container.resize(size);
+        return (uint8_t *)container.data();
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return p_buffer - p_start;
+    }
+
+    void grow(size_t data_size)
+    {
+        const auto used     = size();
+        const auto new_size = std::max(used + data_size, std::max(size_t(p_end - p_start) * 2, size_t(256)));
+        p_start             = p_resize(p_container, new_size);
+        p_buffer            = p_start + used;
+        p_end               = p_start + new_size;
+    }
+
+    void write(uint8_t byte)
+    {
+        if (p_buffer == p_end) [[unlikely]]
+            grow(1);
+
+        *p_buffer++ = byte;
+    }
 
+    void write(const void *data, size_t data_size)
+    {
+        if (size_t(p_end - p_buffer) < data_size) [[unlikely]]
+            grow(data_size);
+
+        memcpy(p_buffer, data, data_size);
+        p_buffer += data_size;
+    }
+};
+
+template <field_attributes = field_attributes{}>
+size_t serialize_size(const auto &value, const spb::field_mask *p_mask = nullptr, bool escape_unicode = true);
+
+/**
+ * @brief write codepoint as `\uXXXX` (or a surrogate pair `\uXXXX\uXXXX`)
+ */
 void write_unicode(auto &stream, uint32_t codepoint)
 {
+    constexpr auto hex   = std::string_view("0123456789abcdef");
+    const auto write_hex = [&](char *p_buffer, uint32_t value)
+    {
+        p_buffer[0] = '\\';
+        p_buffer[1] = 'u';
+        p_buffer[2] = hex[(value >> 12) & 0x0f];
+        p_buffer[3] = hex[(value >> 8) & 0x0f];
+        p_buffer[4] = hex[(value >> 4) & 0x0f];
+        p_buffer[5] = hex[value & 0x0f];
+    };
+
     if (codepoint <= 0xffff)
     {
-        char buffer[8] = {};
-        auto size      = snprintf(buffer, sizeof(buffer), "\\u%04" PRIx32, codepoint);
-        return stream.write(buffer, size);
+        char buffer[6];
+        write_hex(buffer, codepoint);
+        return stream.write(buffer, sizeof(buffer));
     }
     if (codepoint <= 0x10FFFF)
     {
         codepoint -= 0x10000;
 
-        auto high       = static_cast<uint16_t>((codepoint >> 10) + 0xD800);
-        auto low        = static_cast<uint16_t>((codepoint & 0x3FF) + 0xDC00);
-        char buffer[16] = {};
-        auto size       = snprintf(buffer, sizeof(buffer), "\\u%04" PRIx16 "\\u%04" PRIx16, high, low);
-        return stream.write(buffer, size);
+        char buffer[12];
+        write_hex(buffer, (codepoint >> 10) + 0xD800);
+        write_hex(buffer + 6, (codepoint & 0x3FF) + 0xDC00);
+        return stream.write(buffer, sizeof(buffer));
     }
     throw std::invalid_argument("invalid utf8");
 }
@@ -124,90 +216,63 @@ template <size_t N> void write_string(auto &stream, const char (&string)[N])
     stream.write(string, N - 1);
 }
 
-static constexpr auto is_escape(uint8_t c) -> bool
+template <bool escape_unicode> void write_escaped_as(auto &stream, std::string_view str)
 {
-    switch (c)
+    const auto *p_end = str.data() + str.size();
+    for (const auto *p = str.data(); p < p_end;)
     {
-    case '\\':
-    case '\"':
-        return true;
-    default:
-        return (c < ' ') | (c >= 0x80);
-    }
-}
-
-static constexpr auto has_escape_chars(std::string_view str) -> bool
-{
-    return std::any_of(str.begin(), str.end(), is_escape);
-}
-
-void write_escaped(auto &stream, std::string_view str)
-{
-    if (!has_escape_chars(str)) [[likely]]
-    {
-        stream.write(str.data(), str.size());
-        return;
-    }
+        //- runs of safe bytes are copied at once
+        if (const auto safe_size = safe_prefix_size<escape_unicode>(p, p_end); safe_size > 0) [[likely]]
+        {
+            stream.write(p, safe_size);
+            p += safe_size;
+            if (p == p_end)
+                break;
+        }
 
-    uint32_t codepoint = 0;
-    uint32_t state     = spb::detail::utf8::ok;
-    bool decoding_utf8 = false;
-    for (uint8_t c : str)
-    {
-        if (decoding_utf8)
+        const auto c = uint8_t(*p++);
+        if (c < 0x80)
         {
-            if (spb::detail::utf8::decode_point(&state, &codepoint, c) == spb::detail::utf8::ok)
+            if (const auto escape = escape_table[c]; escape == 'u')
             {
-                write_unicode(stream, codepoint);
-                decoding_utf8 = false;
+                write_unicode(stream, c);
             }
-            continue;
-        }
-        if (is_escape(c))
-        {
-            switch (c)
+            else
             {
-            case '"':
-                write_string(stream, R"(\")");
-                break;
-            case '\\':
-                write_string(stream, R"(\\)");
-                break;
-            case '\b':
-                write_string(stream, R"(\b)");
-                break;
-            case '\f':
-                write_string(stream, R"(\f)");
-                break;
-            case '\n':
-                write_string(stream, R"(\n)");
-                break;
-            case '\r':
-                write_string(stream, R"(\r)");
-                break;
-            case '\t':
-                write_string(stream, R"(\t)");
-                break;
-            default:
-                decoding_utf8 = true;
-                if (spb::detail::utf8::decode_point(&state, &codepoint, c) == spb::detail::utf8::ok)
-                {
-                    write_unicode(stream, codepoint);
-                    decoding_utf8 = false;
-                }
+                const char buffer[2] = {'\\', escape};
+                stream.write(buffer, sizeof(buffer));
             }
+            continue;
         }
-        else
+
+        //- whole UTF-8 sequence is decoded into one codepoint
+        uint32_t codepoint = 0;
+        uint32_t state     = spb::detail::utf8::ok;
+        for (auto byte = c;; byte = uint8_t(*p++))
         {
-            stream.write(c);
+            if (spb::detail::utf8::decode_point(&state, &codepoint, byte) == spb::detail::utf8::ok)
+                break;
+
+            if (state == spb::detail::utf8::reject || p == p_end) [[unlikely]]
+                throw std::runtime_error("invalid utf8");
         }
-    }
-    if (state != spb::detail::utf8::ok) [[unlikely]]
-    {
-        throw std::runtime_error("invalid utf8");
+        write_unicode(stream, codepoint);
     }
 }
 
+/**
+ * @brief write JSON string content, non ASCII characters are escaped only if `stream.escape_unicode` is set
+ */
+void write_escaped(auto &stream, std::string_view str)
+{
+    if (stream.escape_unicode) [[likely]]
+        return write_escaped_as<true>(stream, str);
+
+    //- UTF-8 is copied as it is, so it has to be checked up front
+    spb::detail::utf8::validate(str);
+    write_escaped_as<false>(stream, str);
+}
+
 void put_comma_if_needed(auto &stream)
 {
     if (stream.put_comma)
@@ -249,6 +314,19 @@ template <field_attributes> void serialize(auto &stream, const spb::detail::prot
 template <field_attributes>
 void serialize(auto &stream, const spb::detail::proto_field_bytes auto &value, std::string_view field);
 
+template <field_attributes> void serialize(auto &stream, const spb::detail::proto_field_raw auto &value);
+template <field_attributes>
+void serialize(auto &stream, const spb::detail::proto_field_raw auto &value, std::string_view field);
+
+template <field_attributes> void serialize(auto &stream, const spb::detail::proto_cached auto &value);
+template <field_attributes>
+void serialize(auto &stream, const spb::detail::proto_cached auto &value, std::string_view field);
+
+template <field_attributes>
+void serialize(auto &stream, const spb::detail::proto_field_stream_bytes auto &value);
+template <field_attributes>
+void serialize(auto &stream, const spb::detail::proto_field_stream_bytes auto &value, std::string_view field);
+
 template <field_attributes attributes>
 void serialize(auto &stream, const spb::detail::proto_label_optional auto &p_value);
 template <field_attributes attributes>
@@ -357,6 +435,73 @@ void serialize(auto &stream, const spb::detail::proto_field_bytes auto &value, s
     serialize<attributes>(stream, value);
 }
 
+template <field_attributes attributes>
+void serialize(auto &stream, const spb::detail::proto_field_raw auto &value)
+{
+    //- json has no raw form of a sub-message, so it has to be decoded first
+    serialize<attributes>(stream, value.decode());
+}
+
+template <field_attributes attributes>
+void serialize(auto &stream, const spb::detail::proto_field_raw auto &value, std::string_view field)
+{
+    if (value.empty())
+        return;
+
+    serialize_key(stream, field);
+    serialize<attributes>(stream, value);
+}
+
+template <field_attributes attributes>
+void serialize(auto &stream, const spb::detail::proto_cached auto &value)
+{
+    serialize<attributes>(stream, value.value());
+}
+
+template <field_attributes attributes>
+void serialize(auto &stream, const spb::detail::proto_cached auto &value, std::string_view field)
+{
+    serialize<attributes>(stream, value.value(), field);
+}
+
+template <field_attributes attributes>
+void serialize(auto &stream, const spb::detail::proto_field_stream_bytes auto &value)
+{
+    using stream_type = std::remove_cvref_t<decltype(stream)>;
+
+    if constexpr (!stream_type::size_only && attributes.max_size)
+        check_size(value.size(), attributes.max_size);
+
+    stream.write('"');
+    if constexpr (stream_type::size_only)
+    {
+        stream.write(nullptr, (value.size() + 2) / 3 * 4);
+    }
+    else
+    {
+        //- multiple of 3, so only the last chunk can have base64 padding
+        std::byte buffer[3 * 1024];
+        for (auto size = value.size(); size > 0;)
+        {
+            const auto chunk = std::min(size, sizeof(buffer));
+            value.pull({buffer, chunk});
+            base64_encode(stream, {buffer, chunk});
+            size -= chunk;
+        }
+    }
+    stream.write('"');
+}
+
+template <field_attributes attributes>
+void serialize(auto &stream, const spb::detail::proto_field_stream_bytes auto &value, std::string_view field)
+{
+    if (value.empty())
+        return;
+
+    serialize_key(stream, field);
+    serialize<attributes>(stream, value);
+}
+
 template <field_attributes attributes>
 void serialize(auto &stream, const spb::detail::proto_label_repeated auto &value, std::string_view field)
 {
@@ -513,6 +658,29 @@ template <field_attributes> void serialize(auto &stream, const spb::detail::prot
     serialize_value(stream, value);
 }
 
+/**
+ * @brief serialize a field of a message, skips the field if it is not selected by the stream's mask
+ *        sub-messages are serialized with their part of the mask, maps are always whole
+ */
+template <field_attributes attributes>
+void serialize_field(auto &stream, uint32_t number, const auto &value, std::string_view field)
+{
+    const auto *p_mask = stream.p_mask;
+    if (!p_mask) [[likely]]
+        return serialize<attributes>(stream, value, field);
+
+    if (!p_mask->contains(number))
+        return;
+
+    if constexpr (spb::detail::proto_map<std::remove_cvref_t<decltype(value)>>)
+        stream.p_mask = nullptr;
+    else
+        stream.p_mask = p_mask->child(number);
+
+    serialize<attributes>(stream, value, field);
+    stream.p_mask = p_mask;
+}
+
 template <field_attributes>
 void serialize(auto &stream, const spb::detail::proto_enum auto &value, std::string_view field)
 {
@@ -520,9 +688,10 @@ void serialize(auto &stream, const spb::detail::proto_enum auto &value, std::str
     serialize_value(stream, value);
 }
 
-template <field_attributes attributes> size_t serialize_size(const auto &value)
+template <field_attributes attributes>
+size_t serialize_size(const auto &value, const spb::field_mask *p_mask, bool escape_unicode)
 {
-    auto stream = ostream_size();
+    auto stream = ostream_size{.size = 0, .escape_unicode = escape_unicode, .p_mask = p_mask};
     serialize<attributes>(stream, value);
     return stream.size;
 }
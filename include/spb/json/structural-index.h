@@ -0,0 +1,297 @@
+/***************************************************************************\
+* Name        : json structural index                                       *
+* Description : vectorized index of token starts in a JSON document         *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+#pragma once
+
+#include "escape.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace spb::json::detail
+{
+/**
+ * @brief bit masks of one 64 bytes block, bit N is for the byte N
+ */
+struct block_masks
+{
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t white_space;
+    //- { } [ ] : ,
+    uint64_t structural;
+    //- { [
+    uint64_t open;
+    //- } ]
+    uint64_t close;
+};
+
+#if defined(SPB_JSON_ESCAPE_SSE2)
+/**
+ * @brief bits of the 16 bytes `chunk` of a 64 bytes block
+ */
+static inline auto block_bits(__m128i bytes, int chunk) noexcept -> uint64_t
+{
+    return uint64_t(uint16_t(_mm_movemask_epi8(bytes))) << (16 * chunk);
+}
+
+static inline auto classify_block(const char *p) noexcept -> block_masks
+{
+    auto result = block_masks{};
+    for (auto i = 0; i < 4; ++i)
+    {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * i));
+        const auto eq    = [chunk](char c) { return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c)); };
+        const auto bits  = [i](__m128i bytes) { return block_bits(bytes, i); };
+
+        const auto space  = _mm_or_si128(_mm_or_si128(eq(' '), eq('\n')), _mm_or_si128(eq('\t'), eq('\r')));
+        const auto open   = _mm_or_si128(eq('{'), eq('['));
+        const auto close  = _mm_or_si128(eq('}'), eq(']'));
+        const auto colons = _mm_or_si128(eq(':'), eq(','));
+        result.quote |= bits(eq('"'));
+        result.backslash |= bits(eq('\\'));
+        result.white_space |= bits(_mm_or_si128(space, _mm_or_si128(eq('\v'), eq('\f'))));
+        result.structural |= bits(_mm_or_si128(_mm_or_si128(open, close), colons));
+        result.open |= bits(open);
+        result.close |= bits(close);
+    }
+    return result;
+}
+#elif defined(SPB_JSON_ESCAPE_NEON)
+static inline auto classify_block(const char *p) noexcept -> block_masks
+{
+    //- movemask emulation, bit N for byte N
+    static constexpr uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const auto weight                    = vld1q_u8(weights);
+
+    auto result = block_masks{};
+    for (auto i = 0; i < 4; ++i)
+    {
+        const auto chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(p + 16 * i));
+        const auto eq    = [chunk](char c) { return vceqq_u8(chunk, vdupq_n_u8(uint8_t(c))); };
+        const auto bits  = [&](uint8x16_t bytes)
+        {
+            const auto masked = vandq_u8(bytes, weight);
+            const auto low    = uint64_t(vaddv_u8(vget_low_u8(masked)));
+            const auto high   = uint64_t(vaddv_u8(vget_high_u8(masked)));
+            return (low | (high << 8U)) << (16 * i);
+        };
+
+        const auto space  = vorrq_u8(vorrq_u8(eq(' '), eq('\n')), vorrq_u8(eq('\t'), eq('\r')));
+        const auto open   = vorrq_u8(eq('{'), eq('['));
+        const auto close  = vorrq_u8(eq('}'), eq(']'));
+        const auto colons = vorrq_u8(eq(':'), eq(','));
+        result.quote |= bits(eq('"'));
+        result.backslash |= bits(eq('\\'));
+        result.white_space |= bits(vorrq_u8(space, vorrq_u8(eq('\v'), eq('\f'))));
+        result.structural |= bits(vorrq_u8(vorrq_u8(open, close), colons));
+        result.open |= bits(open);
+        result.close |= bits(close);
+    }
+    return result;
+}
+#else
+static inline auto classify_block(const char *p) noexcept -> block_masks
+{
+    auto result = block_masks{};
+    for (auto i = 0; i < 64; ++i)
+    {
+        const auto bit = uint64_t(1) << i;
+        switch (p[i])
+        {
+        case '"':
+            result.quote |= bit;
+            break;
+        case '\\':
+            result.backslash |= bit;
+            break;
+        case ' ':
+        case '\n':
+        case '\t':
+        case '\r':
+        case '\v':
+        case '\f':
+            result.white_space |= bit;
+            break;
+        case '{':
+        case '[':
+            result.open |= bit;
+            result.structural |= bit;
+            break;
+        case '}':
+        case ']':
+            result.close |= bit;
+            result.structural |= bit;
+            break;
+        case ':':
+        case ',':
+            result.structural |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+    return result;
+}
+#endif
+
+/**
+ * @brief characters escaped by an odd sequence of backslashes
+ *
+ * @param backslash backslashes of the block
+ * @param[in,out] carry 1 if the previous block ended with an odd sequence of backslashes
+ */
+static inline auto escaped_characters(uint64_t backslash, uint64_t &carry) noexcept -> uint64_t
+{
+    constexpr auto even_bits = uint64_t(0x5555555555555555ULL);
+    constexpr auto odd_bits  = ~even_bits;
+
+    const auto start_edges     = backslash & ~(backslash << 1U);
+    const auto even_start_mask = even_bits ^ carry;
+    const auto even_starts     = start_edges & even_start_mask;
+    const auto odd_starts      = start_edges & ~even_start_mask;
+    const auto even_carries    = backslash + even_starts;
+    auto odd_carries           = backslash + odd_starts;
+    const auto overflow        = odd_carries < backslash;
+
+    odd_carries |= carry;
+    carry = overflow ? 1 : 0;
+
+    const auto even_carry_ends = even_carries & ~backslash;
+    const auto odd_carry_ends  = odd_carries & ~backslash;
+    return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+}
+
+/**
+ * @brief set all bits from every odd to the next even set bit (bits inside of strings)
+ */
+static constexpr auto prefix_xor(uint64_t bits) noexcept -> uint64_t
+{
+    bits ^= bits << 1U;
+    bits ^= bits << 2U;
+    bits ^= bits << 4U;
+    bits ^= bits << 8U;
+    bits ^= bits << 16U;
+    bits ^= bits << 32U;
+    return bits;
+}
+
+/**
+ * @brief build sorted offsets of all token starts of a JSON document (stage 1 of the indexed parser):
+ *        structural characters and quotes outside of strings and the first character of every literal
+ *        (number, true, false, null), 64 bytes are classified at once (SSE2/NEON)
+ *        first token at or behind a white space is the next non white space character (outside of strings)
+ *
+ * @param json whole document, up to 4 GiB
+ * @return offsets followed by 2 sentinels equal to `json.size()`
+ */
+inline auto build_structural_index(std::string_view json) -> std::vector<uint32_t>
+{
+    if (json.size() >= UINT32_MAX) [[unlikely]]
+        throw std::length_error("too large JSON for structural index");
+
+    auto result = std::vector<uint32_t>();
+    result.reserve(json.size() / 4 + 2);
+
+    auto escape_carry    = uint64_t(0);
+    auto in_string_carry = uint64_t(0);
+    //- document starts as behind a white space
+    auto separator_carry = uint64_t(1);
+    for (auto offset = size_t(0); offset < json.size(); offset += 64)
+    {
+        auto masks = block_masks{};
+        if (json.size() - offset >= 64) [[likely]]
+        {
+            masks = classify_block(json.data() + offset);
+        }
+        else
+        {
+            char tail[64];
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, json.data() + offset, json.size() - offset);
+            masks = classify_block(tail);
+        }
+
+        const auto quote     = masks.quote & ~escaped_characters(masks.backslash, escape_carry);
+        const auto in_string = prefix_xor(quote) ^ in_string_carry;
+        in_string_carry      = uint64_t(int64_t(in_string) >> 63U);
+
+        const auto separator = masks.structural | masks.white_space | quote;
+        const auto literal   = ~separator & ((separator << 1U) | separator_carry);
+        separator_carry      = separator >> 63U;
+
+        //- opening quote is in the string, closing quote is not
+        auto tokens = (masks.structural | quote | literal) & ~(in_string & ~quote);
+        while (tokens != 0)
+        {
+            result.push_back(uint32_t(offset + std::countr_zero(tokens)));
+            tokens &= tokens - 1;
+        }
+    }
+
+    result.push_back(uint32_t(json.size()));
+    result.push_back(uint32_t(json.size()));
+    return result;
+}
+
+/**
+ * @brief finds the end of a JSON object or array fed in 64 bytes blocks, only strings and the bracket depth
+ *        are tracked (no validation of the content, `{]` is accepted as a pair)
+ *        the state is carried between blocks, so the input can be split at any block boundary
+ */
+struct nested_skipper
+{
+    uint64_t escape_carry    = 0;
+    uint64_t in_string_carry = 0;
+    size_t depth             = 0;
+
+    /**
+     * @brief feed next 64 bytes block, the first block starts with the opening `{` or `[`
+     *
+     * @return offset of the closing bracket in the block, 64 if the value continues
+     */
+    auto feed(const char *p_block) noexcept -> size_t
+    {
+        const auto masks     = classify_block(p_block);
+        const auto quote     = masks.quote & ~escaped_characters(masks.backslash, escape_carry);
+        const auto in_string = prefix_xor(quote) ^ in_string_carry;
+        in_string_carry      = uint64_t(int64_t(in_string) >> 63U);
+
+        const auto open  = masks.open & ~in_string;
+        const auto close = masks.close & ~in_string;
+
+        //- depth can't drop to 0 in this block, so there is no need to walk the brackets one by one
+        const auto closes = size_t(std::popcount(close));
+        if (depth > closes) [[likely]]
+        {
+            depth = depth + std::popcount(open) - closes;
+            return 64;
+        }
+
+        for (auto brackets = open | close; brackets != 0; brackets &= brackets - 1)
+        {
+            const auto bit = brackets & (~brackets + 1);
+            if ((open & bit) != 0)
+            {
+                ++depth;
+            }
+            else if (--depth == 0)
+            {
+                return std::countr_zero(bit);
+            }
+        }
+        return 64;
+    }
+};
+
+} // namespace spb::json::detail
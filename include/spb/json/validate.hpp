@@ -0,0 +1,250 @@
+/***************************************************************************\
+* Name        : validate library for json                                   *
+* Description : json validation without deserialization                    *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+
+#pragma once
+
+#include "../concepts.h"
+#include "../utf8.h"
+#include "base64.h"
+#include "deserialize.hpp"
+#include "field.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace spb::json::detail
+{
+/**
+ * @brief throw if some required field was not found
+ *
+ * @param present bit for every required field found in the object
+ * @param required bit for every required field of the message
+ */
+inline void check_required(uint64_t present, uint64_t required)
+{
+    if (present != required) [[unlikely]]
+        throw std::runtime_error("missing required field");
+}
+
+/**
+ * @brief walk all keys of a JSON object, `on_key(stream)` has to consume the key and its value
+ */
+void validate_object(istream_buffer &stream, auto on_key)
+{
+    if (!stream.consume_and_skip_white_space('{')) [[unlikely]]
+        throw std::runtime_error("expecting '{'");
+
+    if (stream.consume_and_skip_white_space('}'))
+        return;
+
+    const auto parent_key = stream.next_key;
+    stream.next_key       = 0;
+    for (;;)
+    {
+        on_key(stream);
+
+        if (stream.consume_and_skip_white_space(','))
+            continue;
+
+        if (stream.consume_and_skip_white_space('}'))
+            break;
+
+        throw std::runtime_error("expecting '}' or ','");
+    }
+    stream.next_key = parent_key;
+}
+
+/**
+ * @brief check JSON string (escapes, UTF-8, size) without copying it
+ */
+template <field_attributes attributes, spb::detail::proto_field_string T>
+void validate_string(istream_buffer &stream)
+{
+    if (!stream.consume('"')) [[unlikely]]
+        throw std::runtime_error(R"(expecting '"')");
+
+    auto size         = size_t(0);
+    auto add_to_value = [&](std::string_view str)
+    {
+        if constexpr (attributes.max_size)
+            check_size(size + str.size(), attributes.max_size);
+
+        //- escapes are ASCII, so they can't split an UTF-8 sequence
+        spb::detail::utf8::validate(str);
+        size += str.size();
+    };
+
+    for (;;)
+    {
+        auto view  = stream.view(1, UINT32_MAX);
+        auto found = stream.find_quote_or_backslash(view);
+        if (found == view.npos) [[unlikely]]
+            throw std::runtime_error("unexpected end of stream");
+
+        add_to_value(view.substr(0, found));
+        // +1 for '"' or '\'
+        stream.skip(found + 1);
+        if (view[found] == '"') [[likely]]
+        {
+            if constexpr (!spb::detail::proto_field_string_resizable<T> &&
+                          !spb::detail::proto_field_string_view<T>)
+            {
+                if (size != T().size()) [[unlikely]]
+                    throw std::runtime_error("invalid string size");
+            }
+            stream.skip_white_spaces();
+            return;
+        }
+        if constexpr (spb::detail::proto_field_string_view<T> &&
+                      !spb::detail::proto_field_string_view_owning<T>)
+            throw std::runtime_error("escaped string can't be borrowed");
+
+        char utf8_buffer[4];
+        auto utf8_size = unescape(stream, utf8_buffer);
+        add_to_value(std::string_view(utf8_buffer, utf8_size));
+    }
+}
+
+template <field_attributes attributes, typename T> void validate(istream_buffer &stream);
+
+template <field_attributes attributes, spb::detail::proto_map T> void validate_map(istream_buffer &stream)
+{
+    using key_type    = typename T::key_type;
+    using mapped_type = typename T::mapped_type;
+
+    if (!stream.consume_and_skip_white_space('{')) [[unlikely]]
+        throw std::runtime_error("expecting '{'");
+
+    if (stream.consume_and_skip_white_space('}'))
+        return;
+
+    do
+    {
+        if constexpr (spb::detail::proto_field_string<key_type>)
+        {
+            validate_string<attributes, key_type>(stream);
+        }
+        else
+        {
+            //- numbers and bools are decoded into a temporary on the stack
+            auto map_key = key_type();
+            deserialize_map_key<attributes>(stream, map_key);
+        }
+        if (!stream.consume_and_skip_white_space(':')) [[unlikely]]
+            throw std::runtime_error("expecting ':'");
+
+        validate<attributes, mapped_type>(stream);
+    } while (stream.consume_and_skip_white_space(','));
+
+    if (!stream.consume_and_skip_white_space('}')) [[unlikely]]
+        throw std::runtime_error("expecting '}'");
+}
+
+template <field_attributes attributes, spb::detail::proto_label_repeated T>
+void validate_repeated(istream_buffer &stream)
+{
+    if (!stream.consume_and_skip_white_space('[')) [[unlikely]]
+        throw std::runtime_error("expecting '['");
+
+    if (stream.consume_and_skip_white_space(']'))
+        return;
+
+    auto count = size_t(0);
+    do
+    {
+        if constexpr (attributes.max_count)
+            check_size(++count, attributes.max_count);
+
+        validate<attributes, typename T::value_type>(stream);
+    } while (stream.consume_and_skip_white_space(','));
+
+    if (!stream.consume_and_skip_white_space(']')) [[unlikely]]
+        throw std::runtime_error("expecting ']'");
+}
+
+/**
+ * @brief validate one JSON value of type `T` without decoding it into `T`
+ */
+template <field_attributes attributes, typename T> void validate(istream_buffer &stream)
+{
+    if constexpr (spb::detail::proto_label_optional<T> || spb::detail::proto_label_repeated<T> ||
+                  spb::detail::proto_map<T> || spb::detail::proto_field_bytes<T> ||
+                  spb::detail::proto_field_stream_bytes<T> || requires { typename T::element_type; })
+    {
+        if (stream.consume_and_skip_white_space("null"sv))
+            return;
+
+        if constexpr (spb::detail::proto_label_optional<T>)
+        {
+            validate<attributes, typename T::value_type>(stream);
+        }
+        else if constexpr (spb::detail::proto_label_repeated<T>)
+        {
+            validate_repeated<attributes, T>(stream);
+        }
+        else if constexpr (spb::detail::proto_map<T>)
+        {
+            validate_map<attributes, T>(stream);
+        }
+        else if constexpr (spb::detail::proto_field_raw<T>)
+        {
+            validate<attributes, typename T::message_type>(stream);
+        }
+        else if constexpr (spb::detail::proto_field_bytes<T> || spb::detail::proto_field_stream_bytes<T>)
+        {
+            const auto size = base64_validate_string(stream, attributes.max_size);
+            if constexpr (spb::detail::proto_field_bytes<T> && !spb::detail::proto_field_bytes_resizable<T>)
+            {
+                if (size != 0 && size != T().size()) [[unlikely]]
+                    throw std::runtime_error("too large base64");
+            }
+        }
+        else
+        {
+            validate<attributes, typename T::element_type>(stream);
+        }
+    }
+    else if constexpr (spb::detail::proto_field_string<T>)
+    {
+        validate_string<attributes, T>(stream);
+    }
+    else if constexpr (spb::detail::proto_cached<T>)
+    {
+        validate<attributes, typename T::message_type>(stream);
+    }
+    else if constexpr (spb::detail::proto_message<T> || spb::detail::proto_enum<T>)
+    {
+        //- generated by the sprotoc
+        validate_value(stream, std::type_identity<T>());
+    }
+    else
+    {
+        //- scalars and fixed size arrays are decoded into a temporary on the stack
+        auto value = T();
+        deserialize<attributes>(stream, value);
+    }
+}
+
+template <field_attributes attributes, typename T>
+void validate_bitfield(istream_buffer &stream, uint32_t bits)
+{
+    (void)deserialize_bitfield<attributes, T>(stream, bits);
+}
+
+template <field_attributes attributes, size_t ordinal, typename T>
+void validate_variant(istream_buffer &stream)
+{
+    validate<attributes, std::variant_alternative_t<ordinal, T>>(stream);
+}
+
+} // namespace spb::json::detail
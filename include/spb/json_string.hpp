@@ -0,0 +1,155 @@
+/***************************************************************************\
+* Name        : json string                                                 *
+* Description : string field borrowed from the input or owned if unescaped  *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace spb
+{
+/**
+ * @brief `string` field which points into the deserialized input (zero-copy), use
+ *        `(spb_opt).string = "spb::json_string"` to generate it
+ *        only strings with escapes (JSON) or strings read from a non contiguous input are copied (owned),
+ *        a borrowed string is valid only as long as the input buffer
+ *
+ * @example `auto person = spb::json::deserialize< Person >( json );`
+ *          `std::string_view name = person.name;`
+ */
+class json_string
+{
+  public:
+    using value_type = char;
+
+    json_string() = default;
+
+    json_string(const char *str) noexcept : view_(str)
+    {
+    }
+
+    json_string(std::string_view str) noexcept : view_(str)
+    {
+    }
+
+    explicit json_string(std::string str)
+    {
+        own(std::move(str));
+    }
+
+    json_string(const json_string &other) : view_(other.view_)
+    {
+        if (other.owned_)
+            own(*other.owned_);
+    }
+
+    json_string(json_string &&other) noexcept
+        : view_(std::exchange(other.view_, {})), owned_(std::move(other.owned_))
+    {
+    }
+
+    auto operator=(const json_string &other) -> json_string &
+    {
+        if (other.owned_)
+            own(*other.owned_);
+        else
+            *this = other.view_;
+        return *this;
+    }
+
+    auto operator=(json_string &&other) noexcept -> json_string &
+    {
+        view_  = std::exchange(other.view_, {});
+        owned_ = std::move(other.owned_);
+        return *this;
+    }
+
+    /**
+     * @brief borrow `str`, it has to outlive the json_string
+     */
+    auto operator=(std::string_view str) noexcept -> json_string &
+    {
+        owned_.reset();
+        view_ = str;
+        return *this;
+    }
+
+    /**
+     * @brief take ownership of `str` (used by deserialize for unescaped strings)
+     */
+    void own(std::string str)
+    {
+        owned_ = std::make_unique<std::string>(std::move(str));
+        view_  = *owned_;
+    }
+
+    /**
+     * @brief true if the string points into the deserialized input
+     */
+    [[nodiscard]] auto is_borrowed() const noexcept -> bool
+    {
+        return !owned_ && !view_.empty();
+    }
+
+    [[nodiscard]] auto data() const noexcept -> const char *
+    {
+        return view_.data();
+    }
+
+    [[nodiscard]] auto size() const noexcept -> size_t
+    {
+        return view_.size();
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return view_.empty();
+    }
+
+    [[nodiscard]] auto begin() const noexcept -> const char *
+    {
+        return data();
+    }
+
+    [[nodiscard]] auto end() const noexcept -> const char *
+    {
+        return data() + size();
+    }
+
+    [[nodiscard]] auto view() const noexcept -> std::string_view
+    {
+        return view_;
+    }
+
+    operator std::string_view() const noexcept
+    {
+        return view_;
+    }
+
+    friend auto operator==(const json_string &lhs, std::string_view rhs) noexcept -> bool
+    {
+        return lhs.view_ == rhs;
+    }
+
+    friend auto operator<=>(const json_string &lhs, std::string_view rhs) noexcept
+    {
+        return lhs.view_ <=> rhs;
+    }
+
+  private:
+    //- points into the input or into `owned_`, the owned string is on the heap, so it stays in place
+    //- when the json_string is moved (e.g. by a growing std::vector)
+    std::string_view view_;
+    std::unique_ptr<std::string> owned_;
+};
+} // namespace spb
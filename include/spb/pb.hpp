@@ -10,12 +10,20 @@
 #pragma once
 
 #include "concepts.h"
+#include "field_mask.hpp"
+#include "pb/builder.hpp"
 #include "pb/deserialize.hpp"
 #include "pb/serialize.hpp"
+#include "pb/validate.hpp"
 #include "spb/io/io.hpp"
 #include "spb/pb/wire-types.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <span>
+#include <vector>
 
 namespace spb::pb
 {
@@ -27,6 +35,12 @@ struct serialize_options
      *        Compatible with Google's `writeDelimitedTo` and NanoPb's PB_ENCODE_DELIMITED.
      */
     bool delimited = false;
+
+    /**
+     * @brief Serialize only the selected fields (and nested paths), nullptr serializes all fields.
+     *        Sub-messages without any selected field are omitted, maps are serialized whole.
+     */
+    const spb::field_mask *mask = nullptr;
 };
 
 struct deserialize_options
@@ -38,6 +52,34 @@ struct deserialize_options
      * from again to get the next message (if any).
      */
     bool delimited = false;
+
+    /**
+     * @brief Decode only the selected fields (and nested paths), all other fields are skipped
+     *        without being decoded or allocated. nullptr decodes all fields.
+     *        The mask has to outlive the deserialize call.
+     */
+    const spb::field_mask *mask = nullptr;
+
+    /**
+     * @brief The input was produced by ourselves (internal RPC, on-disk caches), checks which don't
+     *        guard memory safety (wire types, UTF-8, bool and int ranges) are skipped.
+     *        Only deserialization from a contiguous buffer of messages generated with
+     *        `(spb_msgopt).trusted = true` is affected, other messages are checked as usual.
+     */
+    bool trusted = false;
+
+    /**
+     * @brief Limit memory allocated for the message, 0 is unlimited. Payloads of strings and bytes,
+     *        elements of repeated fields, map entries and sub-messages behind a pointer are charged
+     *        by their size. std::length_error is thrown as soon as the budget is exceeded.
+     */
+    size_t max_allocated_bytes = 0;
+
+    /**
+     * @brief Limit total count of elements of repeated fields and map entries in the whole message,
+     *        0 is unlimited. std::length_error is thrown as soon as the limit is exceeded.
+     */
+    size_t max_total_elements = 0;
 };
 
 /**
@@ -51,9 +93,10 @@ struct deserialize_options
  */
 size_t serialize(const auto &message, spb::io::writer on_write, const serialize_options &options = {})
 {
-    auto stream = detail::ostream_writer{on_write};
+    auto stream   = detail::ostream_writer{on_write};
+    stream.p_mask = options.mask;
     if (options.delimited)
-        detail::serialize_varint(stream, detail::serialize_size(message));
+        detail::serialize_varint(stream, detail::serialize_size(message, options.mask));
 
     serialize_value(stream, message);
     return stream.size;
@@ -68,16 +111,83 @@ size_t serialize(const auto &message, spb::io::writer on_write, const serialize_
  */
 [[nodiscard]] size_t serialize_size(const auto &message, const serialize_options &options = {})
 {
-    const auto size = detail::serialize_size(message);
+    const auto size = detail::serialize_size(message, options.mask);
     return (options.delimited) ? size + detail::serialize_varint_size(size) : size;
 }
 
+/**
+ * @brief output of `serialize_iov`, can be reused between calls
+ */
+struct iovec_builder
+{
+    /**
+     * @brief `bytes` and `string` fields with `size >= threshold` are referenced, not copied
+     *        (minimum is 16 bytes)
+     */
+    size_t threshold = 1024;
+
+    /**
+     * @brief tags, lengths and small fields
+     */
+    std::vector<std::byte> scratch;
+
+    /**
+     * @brief serialized message, ready for `writev`/`sendmsg` (`iovec{chunk.data(), chunk.size()}`)
+     *        chunks point into `scratch` or directly into the message's fields
+     */
+    std::vector<std::span<const std::byte>> chunks;
+};
+
+/**
+ * @brief serialize message as a list of chunks (scatter-gather), large `bytes` and `string`
+ *        fields are referenced in place instead of being copied
+ *        Warning: chunks are valid until the message or the builder is modified
+ *        the message and its sub-messages have to be generated with `(spb_msgopt).iov = true`
+ *
+ * @param[in] message to be serialized
+ * @param[out] builder chunks of the serialized message
+ * @param[in] options
+ * @return serialized size in bytes
+ * @throws std::runtime_error on error
+ * @example `auto builder = spb::pb::iovec_builder{.threshold = 4096};`
+ *          `spb::pb::serialize_iov(message, builder);`
+ */
+size_t serialize_iov(const auto &message, iovec_builder &builder, const serialize_options &options = {})
+{
+    static_assert(detail::message_serializable<detail::ostream_iov, decltype(message)>,
+                  "serialize_iov needs (spb_msgopt).iov = true for the message and all its sub-messages");
+
+    const auto threshold = std::max<size_t>(builder.threshold, 16);
+    const auto size      = options.delimited ? detail::serialize_size(message, options.mask) : 0;
+
+    //- sizing pass, only the scratch size is needed
+    auto size_stream   = detail::ostream_iov(nullptr, threshold, nullptr);
+    size_stream.p_mask = options.mask;
+    if (options.delimited)
+        detail::serialize_varint(size_stream, size);
+
+    serialize_value(size_stream, message);
+
+    builder.scratch.resize(size_stream.scratch_size);
+    builder.chunks.clear();
+
+    auto stream   = detail::ostream_iov(builder.scratch.data(), threshold, &builder.chunks);
+    stream.p_mask = options.mask;
+    if (options.delimited)
+        detail::serialize_varint(stream, size);
+
+    serialize_value(stream, message);
+    stream.flush();
+    return stream.size;
+}
+
 size_t serialize(const auto &message, void *buffer, const serialize_options &options = {})
 {
     const auto start = (uint8_t *)buffer;
     auto stream      = detail::ostream_buffer((uint8_t *)buffer);
+    stream.p_mask    = options.mask;
     if (options.delimited)
-        detail::serialize_varint(stream, detail::serialize_size(message));
+        detail::serialize_varint(stream, detail::serialize_size(message, options.mask));
 
     serialize_value(stream, message);
     return stream.p_buffer - start;
@@ -99,10 +209,11 @@ size_t serialize(const auto &message, Container &result, const serialize_options
 {
     static_assert(sizeof(*result.data()) == sizeof(uint8_t));
 
-    const auto size            = detail::serialize_size(message);
+    const auto size            = detail::serialize_size(message, options.mask);
     const auto serialized_size = options.delimited ? size + detail::serialize_varint_size(size) : size;
     result.resize(serialized_size);
-    auto stream = detail::ostream_buffer((uint8_t *)result.data());
+    auto stream   = detail::ostream_buffer((uint8_t *)result.data());
+    stream.p_mask = options.mask;
     if (options.delimited)
         detail::serialize_varint(stream, size);
 
@@ -127,44 +238,110 @@ template <spb::resizable_container Container = std::string>
     return result;
 }
 
+/**
+ * @brief serialize only the selected top level fields into protobuf, see `serialize_options::mask`
+ *        for nested paths
+ *
+ * @param[in] message to be serialized
+ * @param[in] options
+ * @return serialized protobuf
+ * @throws std::runtime_error on error
+ * @example `auto serialized = spb::pb::serialize< spb::fields< 1, 4 > >( person );`
+ */
+template <spb::detail::field_selection Fields, spb::resizable_container Container = std::string>
+[[nodiscard]] Container serialize(const auto &message, serialize_options options = {})
+{
+    options.mask = &Fields::mask();
+    return serialize<Container>(message, options);
+}
+
 size_t deserialize(auto &message, const void *buffer, size_t size, const deserialize_options &options = {})
 {
-    detail::istream_buffer stream((const uint8_t *)buffer, size);
+    auto budget             = detail::decode_budget(options.max_allocated_bytes, options.max_total_elements);
+    auto deserialize_stream = [&](auto stream) -> size_t
+    {
+        stream.p_mask   = options.mask;
+        stream.p_budget = budget.is_limited() ? &budget : nullptr;
+        if (options.delimited)
+        {
+            const auto substream_length = read_varint<uint32_t>(stream);
+            auto substream              = stream.sub_stream(substream_length);
+            substream.p_mask            = options.mask;
+            deserialize<detail::serialize_mode{}>(substream, message);
+        }
+        else
+        {
+            deserialize<detail::serialize_mode{}>(stream, message);
+        }
+        return size - stream.size();
+    };
+
+    if (options.trusted)
+        return deserialize_stream(detail::istream_trusted((const uint8_t *)buffer, size));
+
+    return deserialize_stream(detail::istream_buffer((const uint8_t *)buffer, size));
+}
+
+/**
+ * @brief deserialize message from protobuf
+ *
+ * @param[in] reader function for handling reads
+ * @param[in] options
+ * @param[out] message deserialized message
+ * @throws std::runtime_error on error
+ */
+size_t deserialize(auto &message, spb::io::reader reader, const deserialize_options &options = {})
+{
+    auto budget = detail::decode_budget(options.max_allocated_bytes, options.max_total_elements);
+    detail::istream_reader stream{reader};
+    stream.p_mask   = options.mask;
+    stream.p_budget = budget.is_limited() ? &budget : nullptr;
     if (options.delimited)
     {
         const auto substream_length = read_varint<uint32_t>(stream);
         auto substream              = stream.sub_stream(substream_length);
+        substream.p_mask            = options.mask;
         deserialize<detail::serialize_mode{}>(substream, message);
     }
     else
     {
         deserialize<detail::serialize_mode{}>(stream, message);
     }
-    return size - stream.size();
+    return stream.consumed_size();
 }
 
 /**
- * @brief deserialize message from protobuf
+ * @brief deserialize message from a chain of (non-contiguous) segments, without concatenating them
+ *        the message and its sub-messages have to be generated with `(spb_msgopt).chain = true`
  *
- * @param[in] reader function for handling reads
+ * @param[in] segments message split into segments (like a network buffer chain)
  * @param[in] options
  * @param[out] message deserialized message
+ * @return consumed size in bytes
  * @throws std::runtime_error on error
+ * @example `auto segments = std::array{std::span<const std::byte>(head), std::span<const std::byte>(tail)};`
+ *          `spb::pb::deserialize(message, segments);`
  */
-size_t deserialize(auto &message, spb::io::reader reader, const deserialize_options &options = {})
+size_t deserialize(auto &message, std::span<const std::span<const std::byte>> segments,
+                   const deserialize_options &options = {})
 {
-    detail::istream_reader stream{reader};
+    auto budget = detail::decode_budget(options.max_allocated_bytes, options.max_total_elements);
+    detail::istream_chain stream{segments};
+    const auto size = stream.size();
+    stream.p_mask   = options.mask;
+    stream.p_budget = budget.is_limited() ? &budget : nullptr;
     if (options.delimited)
     {
         const auto substream_length = read_varint<uint32_t>(stream);
         auto substream              = stream.sub_stream(substream_length);
+        substream.p_mask            = options.mask;
         deserialize<detail::serialize_mode{}>(substream, message);
     }
     else
     {
         deserialize<detail::serialize_mode{}>(stream, message);
     }
-    return stream.consumed_size();
+    return size - stream.size();
 }
 
 /**
@@ -202,6 +379,67 @@ template <typename Message, spb::size_container Container>
     return message;
 }
 
+/**
+ * @brief deserialize message from reader, elements of repeated fields with a handler are passed
+ *        one by one to the handler and they are not stored in the message, elements of packed
+ *        records are passed as soon as they are decoded
+ *
+ * @param[in] reader function for handling reads
+ * @param[in] handlers handlers created by `spb::on_element`
+ * @return deserialized message (without the elements passed to handlers)
+ * @throws std::runtime_error on error
+ * @example `auto book = spb::pb::deserialize_streaming<AddressBook>(reader,`
+ *          `    spb::on_element(&AddressBook::people, [](Person && person) { ... }));`
+ */
+template <typename Message>
+[[nodiscard]] Message deserialize_streaming(spb::io::reader reader, auto... handlers)
+{
+    auto message     = Message{};
+    const auto sinks = std::array<spb::detail::element_sink, sizeof...(handlers)>{
+        spb::detail::make_element_sink(message, handlers)...};
+    auto stream = detail::istream_reader{reader};
+    detail::deserialize_streaming(stream, message, sinks);
+    return message;
+}
+
+/**
+ * @brief deserialize message from protobuf, elements of repeated fields with a handler are passed
+ *        one by one to the handler and they are not stored in the message, elements of packed
+ *        records are passed as soon as they are decoded
+ *
+ * @param[in] protobuf serialized protobuf
+ * @param[in] handlers handlers created by `spb::on_element`
+ * @return deserialized message (without the elements passed to handlers)
+ * @throws std::runtime_error on error
+ */
+template <typename Message>
+[[nodiscard]] Message deserialize_streaming(const spb::size_container auto &protobuf, auto... handlers)
+{
+    auto message     = Message{};
+    const auto sinks = std::array<spb::detail::element_sink, sizeof...(handlers)>{
+        spb::detail::make_element_sink(message, handlers)...};
+    auto stream = detail::istream_buffer{(const uint8_t *)protobuf.data(), protobuf.size()};
+    detail::deserialize_streaming(stream, message, sinks);
+    return message;
+}
+
+/**
+ * @brief deserialize message from a chain of (non-contiguous) segments, without concatenating them
+ *
+ * @param[in] segments message split into segments (like a network buffer chain)
+ * @param[in] options
+ * @return deserialized message
+ * @throws std::runtime_error on error
+ */
+template <typename Message>
+[[nodiscard]] Message deserialize(std::span<const std::span<const std::byte>> segments,
+                                  const deserialize_options &options = {})
+{
+    auto message = Message{};
+    deserialize(message, segments, options);
+    return message;
+}
+
 /**
  * @brief deserialize message from reader
  *
@@ -217,4 +455,104 @@ template <typename Message>
     deserialize(message, reader, options);
     return message;
 }
+
+/**
+ * @brief deserialize only the selected top level fields from protobuf, see `deserialize_options::mask`
+ *        for nested paths
+ *
+ * @param[in] protobuf serialized protobuf
+ * @param[in] options
+ * @return deserialized message, not selected fields are left default
+ * @throws std::runtime_error on error
+ * @example `auto person = spb::pb::deserialize< Person, spb::fields< 1, 4 > >( serialized );`
+ */
+template <typename Message, spb::detail::field_selection Fields>
+[[nodiscard]] Message deserialize(const spb::size_container auto &protobuf, deserialize_options options = {})
+{
+    options.mask = &Fields::mask();
+    auto message = Message{};
+    deserialize(message, protobuf.data(), protobuf.size(), options);
+    return message;
+}
+
+/**
+ * @brief deserialize only the selected top level fields from reader
+ *
+ * @param[in] reader function for handling reads
+ * @param[in] options
+ * @return deserialized message, not selected fields are left default
+ * @throws std::runtime_error on error
+ */
+template <typename Message, spb::detail::field_selection Fields>
+[[nodiscard]] Message deserialize(spb::io::reader reader, deserialize_options options = {})
+{
+    options.mask = &Fields::mask();
+    auto message = Message{};
+    deserialize(message, reader, options);
+    return message;
+}
+
+/**
+ * @brief check that protobuf is a valid `Message` without deserializing it (nothing is allocated)
+ *        checks wire types, tags, `max_size` and `max_count` options, UTF-8 of strings, values of closed
+ *        (proto2) enums and presence of required scalar fields
+ *
+ * @param[in] protobuf serialized protobuf
+ * @throws std::runtime_error if the protobuf is not valid
+ * @example `spb::pb::validate< Person >( serialized );`
+ */
+template <typename Message> void validate(const spb::size_container auto &protobuf)
+{
+    auto stream = detail::istream_buffer{(const uint8_t *)protobuf.data(), protobuf.size()};
+    detail::validate<detail::serialize_mode{}, Message>(stream, detail::wire_type::length_delimited);
+}
+
+/**
+ * @brief already encoded protobuf of a sub-message `T`
+ *        deserialize only copies the encoded bytes, serialize writes them with tag and length
+ *        (the sub-message is never decoded or encoded on the way)
+ *        use `(spb_opt).raw = true` for a message field to generate it
+ *
+ * @example `auto envelope = Envelope{.payload = spb::pb::raw<Payload>(payload)};`
+ *          `auto payload = envelope.payload.decode();`
+ */
+template <typename T> struct raw : public std::vector<std::byte>
+{
+    using message_type = T;
+    using std::vector<std::byte>::vector;
+
+    raw() = default;
+
+    /**
+     * @brief encode message into raw bytes
+     *
+     * @param[in] message to be encoded
+     */
+    explicit raw(const T &message)
+    {
+        encode(message);
+    }
+
+    /**
+     * @brief encode message into raw bytes
+     *
+     * @param[in] message to be encoded
+     * @throws std::runtime_error on error
+     */
+    void encode(const T &message)
+    {
+        serialize(message, static_cast<std::vector<std::byte> &>(*this));
+    }
+
+    /**
+     * @brief decode raw bytes into message
+     *
+     * @return decoded message
+     * @throws std::runtime_error on error
+     */
+    [[nodiscard]] auto decode() const -> T
+    {
+        return deserialize<T>(static_cast<const std::vector<std::byte> &>(*this));
+    }
+};
 } // namespace spb::pb
@@ -0,0 +1,212 @@
+/***************************************************************************\
+* Name        : pb builder                                                  *
+* Description : incremental (streaming) protobuf serialization              *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+#pragma once
+
+#include "serialize.hpp"
+#include "wire-types.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace spb::pb
+{
+/**
+ * @brief streaming builder for a message, generated with `(spb_msgopt).builder = true`
+ *        every `set_<field>` / `add_<field>` call encodes the value and writes it immediately
+ *        so huge messages (like repeated fields with millions of elements) can be written
+ *        without materializing them
+ *
+ * @example `auto b = spb::pb::builder<AddressBook>([&](const void *p_data, size_t size) { ... });`
+ *          `b.add_people(person);`
+ *          `auto p = b.begin_people(); p.set_name("John"); p.end();`
+ */
+template <typename Message> class builder;
+
+/**
+ * @brief common part of all generated builders
+ *        sub-message builders (`begin_<field>()`) are buffered until `end()` and then written
+ *        with tag and length into the parent, memory is bounded by the largest open sub-message
+ *        sub-message builders with a known size (`begin_<field>(size)`) are not buffered at all,
+ *        they write directly into the parent and `end()` checks the declared size
+ *
+ * @warning every sub-message builder has to be closed by `end()`, a buffered one is lost without it
+ *          and one with a known size leaves the parent truncated (asserted in debug builds)
+ *          only one sub-message builder can be open for a parent at a time, opening a second one or
+ *          writing into the parent throws std::runtime_error until it is closed
+ */
+class builder_base
+{
+  public:
+    /**
+     * @brief writer owned by the top level builder, so a temporary lambda can be passed
+     */
+    using owned_writer = std::function<void(const void *p_data, size_t size)>;
+
+  private:
+    struct sink
+    {
+        builder_base *p_self;
+
+        void operator()(const void *p_data, size_t size) const
+        {
+            p_self->write(p_data, size);
+        }
+    };
+
+    owned_writer on_write;
+    builder_base *p_parent = nullptr;
+    builder_base *p_child  = nullptr;
+    uint32_t field         = 0;
+    size_t declared_size   = 0;
+    bool sized             = false;
+    bool closed            = false;
+    std::vector<std::byte> buffer;
+    sink on_stream_write{this};
+
+  protected:
+    detail::ostream_writer stream;
+
+  public:
+    /**
+     * @brief top level builder, writes the message via writer
+     *
+     * @param[in] writer function for handling the writes, it is kept for the builder's lifetime
+     */
+    explicit builder_base(owned_writer writer) : on_write(std::move(writer)), stream(on_stream_write)
+    {
+    }
+
+    /**
+     * @brief buffered sub-message builder, use generated `begin_<field>()` instead
+     *
+     * @throws std::runtime_error if the parent has another open sub-message builder
+     */
+    builder_base(builder_base &parent, uint32_t field_number)
+        : p_parent(&parent), field(field_number), stream(on_stream_write)
+    {
+        open(parent);
+    }
+
+    /**
+     * @brief sub-message builder with known size, use generated `begin_<field>(size)` instead
+     *        tag and length are written immediately, the content is not buffered
+     *
+     * @throws std::runtime_error if the parent has another open sub-message builder
+     */
+    builder_base(builder_base &parent, uint32_t field_number, size_t size)
+        : p_parent(&parent), field(field_number), declared_size(size), sized(true), stream(on_stream_write)
+    {
+        detail::serialize_tag(parent.stream, field, detail::wire_type::length_delimited);
+        detail::serialize_varint(parent.stream, size);
+        open(parent);
+    }
+
+    builder_base(const builder_base &)            = delete;
+    builder_base &operator=(const builder_base &) = delete;
+
+    ~builder_base()
+    {
+        //- a builder left open by an exception is abandoned together with the output
+        assert((closed || !p_parent || std::uncaught_exceptions() > 0) &&
+               "sub-message builder has to be closed by end()");
+        if (p_parent && p_parent->p_child == this)
+            p_parent->p_child = nullptr;
+    }
+
+    /**
+     * @brief number of bytes written so far (without tag and length for sub-messages)
+     */
+    [[nodiscard]] auto size() const noexcept -> size_t
+    {
+        return stream.size;
+    }
+
+    /**
+     * @brief close the sub-message, buffered content is written (with tag and length) into the
+     *        parent, does nothing for a top level builder
+     *
+     * @throws std::runtime_error if the written size does not match the declared size
+     *         or if a sub-message builder of this one is still open
+     */
+    void end()
+    {
+        if (!p_parent || closed)
+            return;
+
+        if (p_child) [[unlikely]]
+            throw std::runtime_error("sub-message builder is open");
+
+        closed            = true;
+        p_parent->p_child = nullptr;
+        if (sized)
+        {
+            if (stream.size != declared_size) [[unlikely]]
+                throw std::runtime_error("invalid sub-message size");
+            return;
+        }
+
+        detail::serialize_tag(p_parent->stream, field, detail::wire_type::length_delimited);
+        detail::serialize_varint(p_parent->stream, buffer.size());
+        p_parent->stream.write(buffer.data(), buffer.size());
+        buffer = {};
+    }
+
+  private:
+    void open(builder_base &parent)
+    {
+        if (parent.p_child) [[unlikely]]
+            throw std::runtime_error("only one sub-message builder can be open at a time");
+
+        parent.p_child = this;
+    }
+
+    void write(const void *p_data, size_t size)
+    {
+        if (p_child) [[unlikely]]
+            throw std::runtime_error("sub-message builder is open");
+
+        if (closed) [[unlikely]]
+            throw std::runtime_error("sub-message is closed");
+
+        forward(p_data, size, stream.size + size);
+    }
+
+    /**
+     * @brief pass `p_data` to the output, content of a sub-message builder with a known size goes
+     *        through the parent without the parent's checks (its open child is the writer)
+     *
+     * @param[in] content_size size of this builder's content including `p_data`
+     */
+    void forward(const void *p_data, size_t size, size_t content_size)
+    {
+        if (!p_parent)
+            return on_write(p_data, size);
+
+        if (!sized)
+        {
+            const auto *p_bytes = static_cast<const std::byte *>(p_data);
+            buffer.insert(buffer.end(), p_bytes, p_bytes + size);
+            return;
+        }
+
+        if (content_size > declared_size) [[unlikely]]
+            throw std::runtime_error("invalid sub-message size");
+
+        p_parent->stream.size += size;
+        p_parent->forward(p_data, size, p_parent->stream.size);
+    }
+};
+
+} // namespace spb::pb
@@ -12,6 +12,8 @@
 
 #include "../bits.h"
 #include "../concepts.h"
+#include "../field_mask.hpp"
+#include "../streaming.hpp"
 #include "../utf8.h"
 #include "wire-types.h"
 #include <climits>
@@ -20,19 +22,56 @@
 #include <cstring>
 #include <limits>
 #include <memory>
+#include <span>
 #include <spb/io/io.hpp>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <type_traits>
 
 namespace spb::pb::detail
 {
 
+/**
+ * @brief memory budget of one deserialize call, shared by all sub-streams
+ *        0 is unlimited
+ */
+struct decode_budget
+{
+    size_t bytes_left;
+    size_t elements_left;
+
+    decode_budget(size_t max_bytes, size_t max_elements) noexcept
+        : bytes_left(max_bytes ? max_bytes : SIZE_MAX), elements_left(max_elements ? max_elements : SIZE_MAX)
+    {
+    }
+
+    [[nodiscard]] bool is_limited() const noexcept
+    {
+        return bytes_left != SIZE_MAX || elements_left != SIZE_MAX;
+    }
+
+    void charge(size_t bytes, size_t elements)
+    {
+        if (bytes > bytes_left || elements > elements_left) [[unlikely]]
+            throw std::length_error("decode budget exceeded");
+
+        bytes_left -= bytes;
+        elements_left -= elements;
+    }
+};
+
 struct istream_reader
 {
     size_t bytes_left;
     size_t consumed_bytes = 0;
     spb::io::reader on_read;
+    //- selected fields of the message in this stream, nullptr for all fields
+    const spb::field_mask *p_mask = nullptr;
+    //- memory budget of the whole message, nullptr for unlimited
+    decode_budget *p_budget       = nullptr;
+    //- handlers for elements of a packed repeated field (see `deserialize_streaming`)
+    std::span<const spb::detail::element_sink> element_sinks;
 
     istream_reader(spb::io::reader reader, size_t size = std::numeric_limits<size_t>::max()) noexcept
         : bytes_left(size), on_read(reader)
@@ -98,7 +137,9 @@ struct istream_reader
 
         bytes_left -= sub_size;
         consumed_bytes += sub_size;
-        return istream_reader(on_read, sub_size);
+        auto result     = istream_reader(on_read, sub_size);
+        result.p_budget = p_budget;
+        return result;
     }
 
     void skip_or_throw(size_t size)
@@ -117,6 +158,12 @@ struct istream_buffer
 {
     const uint8_t *p_start;
     const uint8_t *p_end;
+    //- selected fields of the message in this stream, nullptr for all fields
+    const spb::field_mask *p_mask = nullptr;
+    //- memory budget of the whole message, nullptr for unlimited
+    decode_budget *p_budget       = nullptr;
+    //- handlers for elements of a packed repeated field (see `deserialize_streaming`)
+    std::span<const spb::detail::element_sink> element_sinks;
 
     istream_buffer(const uint8_t *start, const uint8_t *end) noexcept : p_start(start), p_end(end)
     {
@@ -171,7 +218,9 @@ struct istream_buffer
 
         const auto sub_start = p_start;
         p_start += sub_size;
-        return istream_buffer(sub_start, sub_size);
+        auto result     = istream_buffer(sub_start, sub_size);
+        result.p_budget = p_budget;
+        return result;
     }
 
     void skip_or_throw(size_t size)
@@ -183,6 +232,162 @@ struct istream_buffer
     }
 };
 
+/**
+ * @brief input stream over data produced by ourselves (internal RPC, on-disk caches)
+ *        checks which don't guard memory safety (wire types, UTF-8, bool and int ranges)
+ *        are compiled out, bounds checks are kept
+ */
+struct istream_trusted : istream_buffer
+{
+    static constexpr bool trusted = true;
+
+    using istream_buffer::istream_buffer;
+
+    [[nodiscard]] istream_trusted sub_stream(size_t sub_size)
+    {
+        if (size() < sub_size) [[unlikely]]
+            throw std::runtime_error("unexpected end of stream");
+
+        const auto sub_start = p_start;
+        p_start += sub_size;
+        auto result     = istream_trusted(sub_start, sub_size);
+        result.p_budget = p_budget;
+        return result;
+    }
+};
+
+template <typename Stream>
+concept trusted_stream = std::remove_cvref_t<Stream>::trusted;
+
+/**
+ * @brief input stream over a chain of (non-contiguous) segments
+ *        reads are served directly from the current segment, only values straddling
+ *        a segment boundary are assembled byte by byte
+ */
+struct istream_chain
+{
+    const std::span<const std::byte> *p_segment;
+    const std::span<const std::byte> *p_segments_end;
+    const uint8_t *p_start        = nullptr;
+    const uint8_t *p_end          = nullptr;
+    size_t bytes_left             = 0;
+    //- selected fields of the message in this stream, nullptr for all fields
+    const spb::field_mask *p_mask = nullptr;
+    //- memory budget of the whole message, nullptr for unlimited
+    decode_budget *p_budget       = nullptr;
+    //- handlers for elements of a packed repeated field (see `deserialize_streaming`)
+    std::span<const spb::detail::element_sink> element_sinks;
+
+    explicit istream_chain(std::span<const std::span<const std::byte>> segments) noexcept
+        : p_segment(segments.data()), p_segments_end(segments.data() + segments.size())
+    {
+        for (const auto &segment : segments)
+        {
+            bytes_left += segment.size();
+        }
+    }
+
+    size_t size() const noexcept
+    {
+        return bytes_left;
+    }
+    bool empty() const noexcept
+    {
+        return bytes_left == 0;
+    }
+
+    void next_segment()
+    {
+        while (p_start == p_end)
+        {
+            if (p_segment == p_segments_end) [[unlikely]]
+                throw std::runtime_error("unexpected end of stream");
+
+            p_start = (const uint8_t *)p_segment->data();
+            p_end   = p_start + p_segment->size();
+            ++p_segment;
+        }
+    }
+
+    [[nodiscard]] size_t read(void *data, size_t data_size)
+    {
+        data_size   = std::min(data_size, size());
+        auto p_data = (uint8_t *)data;
+        for (auto size_left = data_size; size_left > 0;)
+        {
+            if (p_start == p_end)
+                next_segment();
+
+            const auto chunk_size = std::min(size_left, size_t(p_end - p_start));
+            memcpy(p_data, p_start, chunk_size);
+            p_start += chunk_size;
+            p_data += chunk_size;
+            size_left -= chunk_size;
+        }
+        bytes_left -= data_size;
+        return data_size;
+    }
+
+    [[nodiscard]] uint8_t read_byte_or_throw()
+    {
+        if (bytes_left == 0) [[unlikely]]
+            throw std::runtime_error("unexpected end of stream");
+
+        if (p_start == p_end) [[unlikely]]
+            next_segment();
+
+        --bytes_left;
+        return *p_start++;
+    }
+
+    [[nodiscard]] int read_byte_or_eof()
+    {
+        if (bytes_left == 0) [[unlikely]]
+            return -1;
+
+        if (p_start == p_end) [[unlikely]]
+            next_segment();
+
+        --bytes_left;
+        return *p_start++;
+    }
+
+    void read_exact_or_throw(void *data, size_t data_size)
+    {
+        if (read(data, data_size) != data_size) [[unlikely]]
+            throw std::runtime_error("unexpected end of stream");
+    }
+
+    [[nodiscard]] istream_chain sub_stream(size_t sub_size)
+    {
+        if (size() < sub_size) [[unlikely]]
+            throw std::runtime_error("unexpected end of stream");
+
+        auto result       = *this;
+        result.bytes_left = sub_size;
+        result.p_mask     = nullptr;
+        skip_or_throw(sub_size);
+        return result;
+    }
+
+    void skip_or_throw(size_t size)
+    {
+        if (this->size() < size) [[unlikely]]
+            throw std::runtime_error("unexpected end of stream");
+
+        bytes_left -= size;
+        while (size > 0)
+        {
+            if (p_start == p_end)
+                next_segment();
+
+            const auto chunk_size = std::min(size, size_t(p_end - p_start));
+            p_start += chunk_size;
+            size -= chunk_size;
+        }
+    }
+};
+
 void skip(auto &stream, wire_type);
 
 // template <serialize_mode> void deserialize(auto &stream, auto &value, wire_type type);
@@ -215,6 +420,24 @@ inline void check_wire_type_or_throw(wire_type type1, wire_type type2)
         throw std::runtime_error("invalid wire type");
 }
 
+void check_wire_type_or_throw(const auto &stream, wire_type type1, wire_type type2)
+{
+    if constexpr (!trusted_stream<decltype(stream)>)
+        check_wire_type_or_throw(type1, type2);
+}
+
+/**
+ * @brief charge memory allocated while decoding against the stream's budget (if any)
+ *
+ * @param bytes allocated bytes
+ * @param elements allocated elements of repeated fields and map entries
+ */
+void charge_budget(auto &stream, size_t bytes, size_t elements)
+{
+    if (stream.p_budget) [[unlikely]]
+        stream.p_budget->charge(bytes, elements);
+}
+
 void check_if_empty_or_throw(auto &stream)
 {
     if (!stream.empty()) [[unlikely]]
@@ -246,7 +469,11 @@ void check_if_empty_or_throw(auto &stream)
 
 template <typename T> [[nodiscard]] auto read_varint(auto &stream) -> T
 {
-    if constexpr (std::is_same_v<T, bool>)
+    if constexpr (std::is_same_v<T, bool> && trusted_stream<decltype(stream)>)
+    {
+        return stream.read_byte_or_throw() != 0;
+    }
+    else if constexpr (std::is_same_v<T, bool>)
     {
         switch (stream.read_byte_or_throw())
         {
@@ -277,7 +504,11 @@ template <typename T> [[nodiscard]] auto read_varint(auto &stream) -> T
                     value = T(value);
                 }
                 auto result = T(value);
-                if constexpr (std::is_signed_v<T>)
+                if constexpr (trusted_stream<decltype(stream)>)
+                {
+                    return result;
+                }
+                else if constexpr (std::is_signed_v<T>)
                 {
                     if (result == std::make_signed_t<T>(value)) [[likely]]
                         return result;
@@ -303,6 +534,8 @@ template <serialize_mode>
 void deserialize(auto &stream, spb::detail::proto_field_bytes auto &value, wire_type type);
 template <serialize_mode>
 void deserialize(auto &stream, spb::detail::proto_field_string auto &value, wire_type type);
+template <serialize_mode>
+void deserialize(auto &stream, spb::detail::proto_field_string_view auto &value, wire_type type);
 template <serialize_mode, spb::detail::proto_label_repeated Container>
 void deserialize(auto &stream, Container &value, wire_type type);
 template <serialize_mode, spb::detail::proto_label_repeated_fixed_size Container>
@@ -314,6 +547,10 @@ template <serialize_mode> void deserialize(auto &stream, spb::detail::proto_map
 
 template <serialize_mode, typename T>
 void deserialize(auto &stream, std::unique_ptr<T> &value, wire_type type);
+template <serialize_mode>
+void deserialize(auto &stream, spb::detail::proto_cached auto &value, wire_type type);
+template <serialize_mode>
+void deserialize(auto &stream, spb::detail::proto_field_stream_bytes auto &value, wire_type type);
 
 template <typename T, typename signedT, typename unsignedT> auto create_tmp_var()
 {
@@ -333,21 +570,21 @@ auto deserialize_bitfield(auto &stream, uint32_t bits, wire_type type) -> T
     auto value = T();
     if constexpr (scalar_encoder(mode.encoder) == scalar_encoder::svarint)
     {
-        check_wire_type_or_throw(type, wire_type::varint);
+        check_wire_type_or_throw(stream, type, wire_type::varint);
 
         auto tmp = read_varint<std::make_unsigned_t<T>>(stream);
         value    = T((tmp >> 1) ^ (~(tmp & 1) + 1));
     }
     else if constexpr (scalar_encoder(mode.encoder) == scalar_encoder::varint)
     {
-        check_wire_type_or_throw(type, wire_type::varint);
+        check_wire_type_or_throw(stream, type, wire_type::varint);
         value = read_varint<T>(stream);
     }
     else if constexpr (scalar_encoder(mode.encoder) == scalar_encoder::i32)
     {
         static_assert(sizeof(T) <= sizeof(uint32_t));
 
-        check_wire_type_or_throw(type, wire_type::fixed32);
+        check_wire_type_or_throw(stream, type, wire_type::fixed32);
 
         if constexpr (sizeof(value) == sizeof(uint32_t))
         {
@@ -357,14 +594,15 @@ auto deserialize_bitfield(auto &stream, uint32_t bits, wire_type type) -> T
         {
             auto tmp = create_tmp_var<T, int32_t, uint32_t>();
             stream.read_exact_or_throw(&tmp, sizeof(tmp));
-            spb::detail::check_if_value_fit_in_bits(tmp, bits);
+            if constexpr (!trusted_stream<decltype(stream)>)
+                spb::detail::check_if_value_fit_in_bits(tmp, bits);
             value = T(tmp);
         }
     }
     else if constexpr (scalar_encoder(mode.encoder) == scalar_encoder::i64)
     {
         static_assert(sizeof(T) <= sizeof(uint64_t));
-        check_wire_type_or_throw(type, wire_type::fixed64);
+        check_wire_type_or_throw(stream, type, wire_type::fixed64);
 
         if constexpr (sizeof(value) == sizeof(uint64_t))
         {
@@ -374,11 +612,13 @@ auto deserialize_bitfield(auto &stream, uint32_t bits, wire_type type) -> T
         {
             auto tmp = create_tmp_var<T, int64_t, uint64_t>();
             stream.read_exact_or_throw(&tmp, sizeof(tmp));
-            spb::detail::check_if_value_fit_in_bits(tmp, bits);
+            if constexpr (!trusted_stream<decltype(stream)>)
+                spb::detail::check_if_value_fit_in_bits(tmp, bits);
             value = T(tmp);
         }
     }
-    spb::detail::check_if_value_fit_in_bits(value, bits);
+    if constexpr (!trusted_stream<decltype(stream)>)
+        spb::detail::check_if_value_fit_in_bits(value, bits);
     return value;
 }
 
@@ -390,7 +630,7 @@ void deserialize(auto &stream, spb::detail::proto_enum auto &value, wire_type ty
 
     if constexpr (!is_packed(mode.encoder))
     {
-        check_wire_type_or_throw(type, wire_type::varint);
+        check_wire_type_or_throw(stream, type, wire_type::varint);
     }
 
     value = T(read_varint<int_type>(stream));
@@ -405,7 +645,7 @@ void deserialize(auto &stream, spb::detail::proto_field_int_or_float auto &value
     {
         if constexpr (!is_packed(mode.encoder))
         {
-            check_wire_type_or_throw(type, wire_type::varint);
+            check_wire_type_or_throw(stream, type, wire_type::varint);
         }
         auto tmp = read_varint<std::make_unsigned_t<T>>(stream);
         value    = T((tmp >> 1) ^ (~(tmp & 1) + 1));
@@ -414,7 +654,7 @@ void deserialize(auto &stream, spb::detail::proto_field_int_or_float auto &value
     {
         if constexpr (!is_packed(mode.encoder))
         {
-            check_wire_type_or_throw(type, wire_type::varint);
+            check_wire_type_or_throw(stream, type, wire_type::varint);
         }
         value = read_varint<T>(stream);
     }
@@ -424,7 +664,7 @@ void deserialize(auto &stream, spb::detail::proto_field_int_or_float auto &value
 
         if constexpr (!is_packed(mode.encoder))
         {
-            check_wire_type_or_throw(type, wire_type::fixed32);
+            check_wire_type_or_throw(stream, type, wire_type::fixed32);
         }
         if constexpr (sizeof(value) == sizeof(uint32_t))
         {
@@ -436,8 +676,12 @@ void deserialize(auto &stream, spb::detail::proto_field_int_or_float auto &value
             {
                 auto tmp = int32_t(0);
                 stream.read_exact_or_throw(&tmp, sizeof(tmp));
-                if (tmp > std::numeric_limits<T>::max() || tmp < std::numeric_limits<T>::min()) [[unlikely]]
-                    throw std::runtime_error("int overflow");
+                if constexpr (!trusted_stream<decltype(stream)>)
+                {
+                    if (tmp > std::numeric_limits<T>::max() ||
+                        tmp < std::numeric_limits<T>::min()) [[unlikely]]
+                        throw std::runtime_error("int overflow");
+                }
 
                 value = T(tmp);
             }
@@ -445,8 +689,11 @@ void deserialize(auto &stream, spb::detail::proto_field_int_or_float auto &value
             {
                 auto tmp = uint32_t(0);
                 stream.read_exact_or_throw(&tmp, sizeof(tmp));
-                if (tmp > std::numeric_limits<T>::max()) [[unlikely]]
-                    throw std::runtime_error("int overflow");
+                if constexpr (!trusted_stream<decltype(stream)>)
+                {
+                    if (tmp > std::numeric_limits<T>::max()) [[unlikely]]
+                        throw std::runtime_error("int overflow");
+                }
 
                 value = T(tmp);
             }
@@ -457,7 +704,7 @@ void deserialize(auto &stream, spb::detail::proto_field_int_or_float auto &value
         static_assert(sizeof(T) <= sizeof(uint64_t));
         if constexpr (!is_packed(mode.encoder))
         {
-            check_wire_type_or_throw(type, wire_type::fixed64);
+            check_wire_type_or_throw(stream, type, wire_type::fixed64);
         }
         if constexpr (sizeof(value) == sizeof(uint64_t))
         {
@@ -469,8 +716,12 @@ void deserialize(auto &stream, spb::detail::proto_field_int_or_float auto &value
             {
                 auto tmp = int64_t(0);
                 stream.read_exact_or_throw(&tmp, sizeof(tmp));
-                if (tmp > std::numeric_limits<T>::max() || tmp < std::numeric_limits<T>::min()) [[unlikely]]
-                    throw std::runtime_error("int overflow");
+                if constexpr (!trusted_stream<decltype(stream)>)
+                {
+                    if (tmp > std::numeric_limits<T>::max() ||
+                        tmp < std::numeric_limits<T>::min()) [[unlikely]]
+                        throw std::runtime_error("int overflow");
+                }
 
                 value = T(tmp);
             }
@@ -478,8 +729,11 @@ void deserialize(auto &stream, spb::detail::proto_field_int_or_float auto &value
             {
                 auto tmp = uint64_t(0);
                 stream.read_exact_or_throw(&tmp, sizeof(tmp));
-                if (tmp > std::numeric_limits<T>::max()) [[unlikely]]
-                    throw std::runtime_error("int overflow");
+                if constexpr (!trusted_stream<decltype(stream)>)
+                {
+                    if (tmp > std::numeric_limits<T>::max()) [[unlikely]]
+                        throw std::runtime_error("int overflow");
+                }
 
                 value = T(tmp);
             }
@@ -497,12 +751,13 @@ void deserialize(auto &stream, Container &p_value, wire_type type)
 template <serialize_mode mode>
 void deserialize(auto &stream, spb::detail::proto_field_string auto &value, wire_type type)
 {
-    check_wire_type_or_throw(type, wire_type::length_delimited);
+    check_wire_type_or_throw(stream, type, wire_type::length_delimited);
     if constexpr (mode.max_size)
         check_size(stream.size(), mode.max_size);
 
     if constexpr (spb::detail::proto_field_string_resizable<decltype(value)>)
     {
+        charge_budget(stream, stream.size(), 0);
         value.resize(stream.size());
     }
     else
@@ -511,26 +766,68 @@ void deserialize(auto &stream, spb::detail::proto_field_string auto &value, wire
             throw std::runtime_error("invalid string size");
     }
     stream.read_exact_or_throw(value.data(), stream.size());
-    spb::detail::utf8::validate(std::string_view(value.data(), value.size()));
+    if constexpr (!trusted_stream<decltype(stream)>)
+        spb::detail::utf8::validate(std::string_view(value.data(), value.size()));
+}
+
+/**
+ * @brief string is pointed into a contiguous input (zero-copy), anything else is copied into an owning
+ *        view (`spb::json_string`) or rejected at compile time for a plain `std::string_view`
+ */
+template <serialize_mode mode>
+void deserialize(auto &stream, spb::detail::proto_field_string_view auto &value, wire_type type)
+{
+    if constexpr (std::is_base_of_v<istream_buffer, std::remove_cvref_t<decltype(stream)>>)
+    {
+        check_wire_type_or_throw(stream, type, wire_type::length_delimited);
+        if constexpr (mode.max_size)
+            check_size(stream.size(), mode.max_size);
+
+        const auto str = std::string_view(reinterpret_cast<const char *>(stream.p_start), stream.size());
+        if constexpr (!trusted_stream<decltype(stream)>)
+            spb::detail::utf8::validate(str);
+
+        value = str;
+        stream.skip_or_throw(str.size());
+    }
+    else if constexpr (spb::detail::proto_field_string_view_owning<decltype(value)>)
+    {
+        auto owned = std::string();
+        deserialize<mode>(stream, owned, type);
+        value.own(std::move(owned));
+    }
+    else
+    {
+        static_assert(spb::detail::proto_field_string_view_owning<decltype(value)>,
+                      "std::string_view needs a contiguous input, use spb::json_string for other inputs");
+    }
 }
 
 template <serialize_mode mode, typename T>
 void deserialize(auto &stream, std::unique_ptr<T> &value, wire_type type)
 {
+    charge_budget(stream, sizeof(T), 0);
     value = std::make_unique<T>();
     deserialize<mode>(stream, *value, type);
 }
 
+template <serialize_mode mode>
+void deserialize(auto &stream, spb::detail::proto_cached auto &value, wire_type type)
+{
+    deserialize<mode>(stream, value.mutable_value(), type);
+}
+
 template <serialize_mode mode>
 void deserialize(auto &stream, spb::detail::proto_field_bytes auto &value, wire_type type)
 {
-    check_wire_type_or_throw(type, wire_type::length_delimited);
+    check_wire_type_or_throw(stream, type, wire_type::length_delimited);
 
     if constexpr (mode.max_size)
         check_size(stream.size(), mode.max_size);
 
     if constexpr (spb::detail::proto_field_bytes_resizable<decltype(value)>)
     {
+        charge_budget(stream, stream.size(), 0);
         value.resize(stream.size());
     }
     else
@@ -541,6 +838,23 @@ void deserialize(auto &stream, spb::detail::proto_field_bytes auto &value, wire_
     stream.read_exact_or_throw(value.data(), stream.size());
 }
 
+template <serialize_mode mode>
+void deserialize(auto &stream, spb::detail::proto_field_stream_bytes auto &value, wire_type type)
+{
+    check_wire_type_or_throw(stream, type, wire_type::length_delimited);
+
+    if constexpr (mode.max_size)
+        check_size(stream.size(), mode.max_size);
+
+    std::byte buffer[4096];
+    while (!stream.empty())
+    {
+        const auto chunk = std::min(stream.size(), sizeof(buffer));
+        stream.read_exact_or_throw(buffer, chunk);
+        value.push({buffer, chunk});
+    }
+}
+
 template <serialize_mode mode, spb::detail::proto_label_repeated Container>
 void deserialize_packed(auto &stream, Container &value)
 {
@@ -551,6 +865,7 @@ void deserialize_packed(auto &stream, Container &value)
         if constexpr (mode.max_count)
             check_size(value.size() + 1, mode.max_count);
 
+        charge_budget(stream, sizeof(typename Container::value_type), 1);
         if constexpr (std::is_same_v<typename Container::value_type, bool>)
         {
             value.emplace_back(read_varint<bool>(stream));
@@ -559,6 +874,9 @@ void deserialize_packed(auto &stream, Container &value)
         {
             deserialize<reset_packed(mode)>(stream, value.emplace_back(), to_wire_type(mode.encoder));
         }
+
+        if (!stream.element_sinks.empty()) [[unlikely]]
+            spb::detail::flush_elements(stream.element_sinks, &value);
     }
 }
 
@@ -590,7 +908,7 @@ void deserialize(auto &stream, Container &value, wire_type type)
 {
     static_assert(is_packed(mode.encoder), "repeated field with fixed size has to have attribute 'packed'");
 
-    check_wire_type_or_throw(type, wire_type::length_delimited);
+    check_wire_type_or_throw(stream, type, wire_type::length_delimited);
     deserialize_packed<mode>(stream, value);
 }
 
@@ -606,6 +924,7 @@ void deserialize(auto &stream, Container &value, wire_type type)
         if constexpr (mode.max_count)
             check_size(value.size() + 1, mode.max_count);
 
+        charge_budget(stream, sizeof(typename Container::value_type), 1);
         if constexpr (std::is_same_v<typename Container::value_type, bool>)
         {
             value.emplace_back(read_varint<bool>(stream));
@@ -627,7 +946,8 @@ void deserialize(auto &stream, spb::detail::proto_map auto &value, wire_type typ
     constexpr auto key_encoder   = serialize_mode{.encoder = mode.encoder};
     constexpr auto value_encoder = serialize_mode{.encoder = mode.encoder2};
 
-    check_wire_type_or_throw(type, wire_type::length_delimited);
+    check_wire_type_or_throw(stream, type, wire_type::length_delimited);
+    charge_budget(stream, sizeof(std::pair<key_type, mapped_type>), 1);
 
     auto pair          = std::pair<key_type, mapped_type>();
     auto key_defined   = false;
@@ -704,11 +1024,26 @@ void deserialize_variant(auto &stream, T &variant, wire_type type)
     deserialize<mode>(stream, variant.template emplace<ordinal>(), type);
 }
 
+/**
+ * @brief false for messages with `std::string_view` fields and a reader or a chain, the generated
+ *        `deserialize_value` is deleted for them, and for a chain without `(spb_msgopt).chain`
+ */
+template <typename Stream, typename Message>
+concept message_deserializable =
+    requires(std::remove_cvref_t<Stream> &stream, std::remove_cvref_t<Message> &message, tag_type tag) {
+    deserialize_value(stream, message, tag);
+};
+
 template <serialize_mode>
 void deserialize(auto &stream, spb::detail::proto_message auto &value, wire_type type)
 {
-    check_wire_type_or_throw(type, wire_type::length_delimited);
+    static_assert(message_deserializable<decltype(stream), decltype(value)>,
+                  "std::string_view fields need a contiguous input (use spb::json_string for other inputs), "
+                  "segments need (spb_msgopt).chain = true for the message and all its sub-messages");
 
+    check_wire_type_or_throw(stream, type, wire_type::length_delimited);
+
+    const auto *p_mask = stream.p_mask;
     while (!stream.empty())
     {
         const auto tag = read_tag_or_eof(stream);
@@ -720,11 +1055,26 @@ void deserialize(auto &stream, spb::detail::proto_message auto &value, wire_type
         {
             const auto size = read_varint<uint32_t>(stream);
             auto substream  = stream.sub_stream(size);
+            if (p_mask) [[unlikely]]
+            {
+                //- masked out fields are skipped without decoding
+                if (!p_mask->contains(field_from_tag(tag)))
+                {
+                    skip(substream, field_type);
+                    continue;
+                }
+                substream.p_mask = p_mask->child(field_from_tag(tag));
+            }
             deserialize_value(substream, value, tag);
             check_if_empty_or_throw(substream);
         }
         else
         {
+            if (p_mask && !p_mask->contains(field_from_tag(tag))) [[unlikely]]
+            {
+                skip(stream, field_type);
+                continue;
+            }
             deserialize_value(stream, value, tag);
         }
     }
@@ -734,6 +1084,100 @@ template <serialize_mode mode> void deserialize(auto &stream, spb::detail::proto
     return deserialize<mode>(stream, value, wire_type::length_delimited);
 }
 
+/**
+ * @brief deserialize top level message, repeated fields with a handler are flushed after every field
+ *        and after every element of a packed record, so they never hold more than one element
+ */
+void deserialize_streaming(auto &stream, spb::detail::proto_message auto &value,
+                           std::span<const spb::detail::element_sink> sinks)
+{
+    static_assert(message_deserializable<decltype(stream), decltype(value)>,
+                  "std::string_view fields need a contiguous input, use spb::json_string for other inputs");
+
+    while (!stream.empty())
+    {
+        const auto tag = read_tag_or_eof(stream);
+        if (tag == tag_type::invalid)
+            return;
+
+        const auto field_type = wire_type_from_tag(tag);
+        if (field_type == wire_type::length_delimited)
+        {
+            const auto size         = read_varint<uint32_t>(stream);
+            auto substream          = stream.sub_stream(size);
+            substream.element_sinks = sinks;
+            deserialize_value(substream, value, tag);
+            check_if_empty_or_throw(substream);
+        }
+        else
+        {
+            deserialize_value(stream, value, tag);
+        }
+        spb::detail::flush_elements(sinks);
+    }
+}
+
+/**
+ * @brief append an unknown field (tag + payload) into `value` without decoding the payload,
+ *        so it can be written back by `serialize_unknown`
+ *
+ * @param stream for `wire_type::length_delimited` this is already the field's sub-stream
+ * @param value raw bytes of all unknown fields
+ * @param tag field's tag
+ */
+void deserialize_unknown(auto &stream, spb::detail::proto_field_bytes_resizable auto &value, tag_type tag)
+{
+    uint8_t header[2 * 10];
+    auto header_size = size_t(0);
+
+    auto write_varint = [&](uint64_t varint)
+    {
+        while (varint >= 0x80)
+        {
+            header[header_size++] = uint8_t(varint & 0x7F) | 0x80;
+            varint >>= 7;
+        }
+        header[header_size++] = uint8_t(varint);
+    };
+
+    write_varint(uint32_t(tag));
+
+    auto payload_size = size_t(0);
+    switch (wire_type_from_tag(tag))
+    {
+    case wire_type::varint:
+        for (auto varint_size = 1U;; ++varint_size)
+        {
+            if (varint_size > 10) [[unlikely]]
+                throw std::runtime_error("invalid varint");
+
+            const auto byte       = stream.read_byte_or_throw();
+            header[header_size++] = byte;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+        break;
+    case wire_type::length_delimited:
+        payload_size = stream.size();
+        write_varint(payload_size);
+        break;
+    case wire_type::fixed32:
+        payload_size = sizeof(uint32_t);
+        break;
+    case wire_type::fixed64:
+        payload_size = sizeof(uint64_t);
+        break;
+    default:
+        throw std::runtime_error("invalid wire type");
+    }
+
+    const auto offset = value.size();
+    charge_budget(stream, header_size + payload_size, 0);
+    value.resize(offset + header_size + payload_size);
+    memcpy(value.data() + offset, header, header_size);
+    stream.read_exact_or_throw(value.data() + offset + header_size, payload_size);
+}
+
 void skip(auto &stream, wire_type type)
 {
     switch (type)
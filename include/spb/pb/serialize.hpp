@@ -11,15 +11,20 @@
 #pragma once
 
 #include "../concepts.h"
+#include "../field_mask.hpp"
 #include "../utf8.h"
 #include "wire-types.h"
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <memory>
+#include <span>
 #include <spb/io/io.hpp>
 #include <sys/types.h>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace spb::pb::detail
 {
@@ -27,6 +32,8 @@ struct ostream_size
 {
     static constexpr bool size_only = true;
     size_t size;
+    //- selected fields of the message being serialized, nullptr for all fields
+    const spb::field_mask *p_mask = nullptr;
 
     void write(const void *, size_t data_size)
     {
@@ -42,6 +49,7 @@ struct ostream_buffer
 {
     static constexpr bool size_only = false;
     uint8_t *p_buffer;
+    const spb::field_mask *p_mask = nullptr;
 
     explicit ostream_buffer(void *buffer) : p_buffer((uint8_t *)buffer)
     {
@@ -63,7 +71,8 @@ struct ostream_writer
 {
     static constexpr bool size_only = false;
     spb::io::writer on_write;
-    size_t size = 0;
+    size_t size                   = 0;
+    const spb::field_mask *p_mask = nullptr;
 
     explicit ostream_writer(spb::io::writer writer) : on_write(writer)
     {
@@ -81,7 +90,66 @@ struct ostream_writer
     }
 };
 
-template <serialize_mode = serialize_mode{}> size_t serialize_size(const auto &value);
+/**
+ * @brief scatter-gather stream
+ *        writes with `size >= threshold` are only referenced (they point into the message's
+ *        bytes/string fields), all other writes are copied into the scratch buffer
+ *        without `p_scratch` it only counts the scratch size (sizing pass)
+ */
+struct ostream_iov
+{
+    static constexpr bool size_only = false;
+    std::byte *p_scratch;
+    size_t threshold;
+    std::vector<std::span<const std::byte>> *p_chunks;
+    size_t size                   = 0;
+    size_t scratch_size           = 0;
+    size_t chunk_start            = 0;
+    const spb::field_mask *p_mask = nullptr;
+
+    ostream_iov(std::byte *scratch, size_t threshold_size,
+                std::vector<std::span<const std::byte>> *chunks) noexcept
+        : p_scratch(scratch), threshold(threshold_size), p_chunks(chunks)
+    {
+    }
+
+    void write(uint8_t byte)
+    {
+        if (p_scratch)
+            p_scratch[scratch_size] = std::byte(byte);
+
+        ++scratch_size;
+        ++size;
+    }
+
+    void write(const void *data, size_t data_size)
+    {
+        size += data_size;
+        if (data_size >= threshold)
+        {
+            flush();
+            if (p_chunks)
+                p_chunks->emplace_back((const std::byte *)data, data_size);
+            return;
+        }
+
+        if (p_scratch)
+            memcpy(p_scratch + scratch_size, data, data_size);
+
+        scratch_size += data_size;
+    }
+
+    void flush()
+    {
+        if (p_chunks && scratch_size > chunk_start)
+            p_chunks->emplace_back(p_scratch + chunk_start, scratch_size - chunk_start);
+
+        chunk_start = scratch_size;
+    }
+};
+
+template <serialize_mode = serialize_mode{}>
+size_t serialize_size(const auto &value, const spb::field_mask *p_mask = nullptr);
 template <serialize_mode = serialize_mode{}> size_t serialize_size(uint32_t field, const auto &value);
 template <serialize_mode> void serialize(auto &stream, const spb::detail::proto_message auto &value);
 
@@ -131,6 +199,10 @@ void serialize(auto &stream, uint32_t field, const spb::detail::proto_label_repe
 
 template <serialize_mode>
 void serialize(auto &stream, uint32_t field, const spb::detail::proto_map auto &value);
+template <serialize_mode>
+void serialize(auto &stream, uint32_t field, const spb::detail::proto_cached auto &value);
+template <serialize_mode>
+void serialize(auto &stream, uint32_t field, const spb::detail::proto_field_stream_bytes auto &value);
 
 template <serialize_mode mode>
 void serialize(auto &stream, uint32_t field, spb::detail::proto_field_number auto value)
@@ -272,6 +344,23 @@ void serialize(auto &stream, uint32_t field, const spb::detail::proto_field_byte
     if (value.empty())
         return;
 
+    if constexpr (spb::detail::proto_field_raw<std::remove_cvref_t<decltype(value)>>)
+    {
+        //- a mask selects fields inside of the sub-message, the pre-encoded bytes have all of them
+        if (stream.p_mask) [[unlikely]]
+        {
+            if constexpr (std::is_same_v<stream_type, ostream_iov>)
+            {
+                //- the decoded sub-message is a temporary, its fields are copied instead of referenced
+                const auto threshold = std::exchange(stream.threshold, std::numeric_limits<size_t>::max());
+                serialize<mode>(stream, field, value.decode());
+                stream.threshold = threshold;
+                return;
+            }
+            return serialize<mode>(stream, field, value.decode());
+        }
+    }
+
     if constexpr (!stream_type::size_only && mode.max_size)
         check_size(value.size(), mode.max_size);
 
@@ -280,22 +369,28 @@ void serialize(auto &stream, uint32_t field, const spb::detail::proto_field_byte
     stream.write(value.data(), value.size());
 }
 
+template <serialize_mode mode>
+void serialize_map_entry(auto &stream, uint32_t field, const auto &key, const auto &value)
+{
+    constexpr auto key_encoder   = serialize_mode{.encoder = mode.encoder};
+    constexpr auto value_encoder = serialize_mode{.encoder = mode.encoder2};
+
+    const auto size = serialize_size<key_encoder>(1, key) + serialize_size<value_encoder>(2, value);
+    serialize_tag(stream, field, wire_type::length_delimited);
+    serialize_varint(stream, size);
+    serialize<key_encoder>(stream, 1, key);
+    serialize<value_encoder>(stream, 2, value);
+}
+
 template <serialize_mode mode>
 void serialize(auto &stream, uint32_t field, const spb::detail::proto_map auto &value)
 {
     if (value.empty())
         return;
 
-    constexpr auto key_encoder   = serialize_mode{.encoder = mode.encoder};
-    constexpr auto value_encoder = serialize_mode{.encoder = mode.encoder2};
-
     for (const auto &[k, v] : value)
     {
-        const auto size = serialize_size<key_encoder>(1, k) + serialize_size<value_encoder>(2, v);
-        serialize_tag(stream, field, wire_type::length_delimited);
-        serialize_varint(stream, size);
-        serialize<key_encoder>(stream, 1, k);
-        serialize<value_encoder>(stream, 2, v);
+        serialize_map_entry<mode>(stream, field, k, v);
     }
 }
 
@@ -356,10 +451,23 @@ void serialize(auto &stream, uint32_t field, const std::unique_ptr<T> &p_value)
         serialize<mode>(stream, field, *p_value);
 }
 
+/**
+ * @brief false for messages without the generated `serialize_value` for the stream,
+ *        `ostream_iov` needs `(spb_msgopt).iov` or `(spb_fileopt).iov`
+ */
+template <typename Stream, typename Message>
+concept message_serializable =
+    requires(std::remove_cvref_t<Stream> &stream, const std::remove_cvref_t<Message> &message) {
+    serialize_value(stream, message);
+};
+
 template <serialize_mode mode>
 void serialize(auto &stream, uint32_t field, const spb::detail::proto_message auto &value)
 {
-    const auto size = serialize_size<mode>(value);
+    static_assert(message_serializable<decltype(stream), decltype(value)>,
+                  "serialize_iov needs (spb_msgopt).iov = true for the message and all its sub-messages");
+
+    const auto size = serialize_size<mode>(value, stream.p_mask);
     if (!size) [[unlikely]]
         return;
 
@@ -368,9 +476,91 @@ void serialize(auto &stream, uint32_t field, const spb::detail::proto_message au
     serialize_value(stream, value);
 }
 
-template <serialize_mode mode> auto serialize_size(const auto &value) -> size_t
+/**
+ * @brief serialize a field of a message, skips the field if it is not selected by the stream's mask
+ *        sub-messages are serialized with their part of the mask, maps are always whole
+ */
+template <serialize_mode mode> void serialize_field(auto &stream, uint32_t field, const auto &value)
 {
-    auto stream = ostream_size();
+    const auto *p_mask = stream.p_mask;
+    if (!p_mask) [[likely]]
+        return serialize<mode>(stream, field, value);
+
+    if (!p_mask->contains(field))
+        return;
+
+    if constexpr (spb::detail::proto_map<std::remove_cvref_t<decltype(value)>>)
+        stream.p_mask = nullptr;
+    else
+        stream.p_mask = p_mask->child(field);
+
+    serialize<mode>(stream, field, value);
+    stream.p_mask = p_mask;
+}
+
+/**
+ * @brief write unknown fields (collected by `deserialize_unknown`) back verbatim
+ */
+void serialize_unknown(auto &stream, const spb::detail::proto_field_bytes auto &value)
+{
+    if (!value.empty())
+        stream.write(value.data(), value.size());
+}
+
+template <serialize_mode mode>
+void serialize(auto &stream, uint32_t field, const spb::detail::proto_cached auto &value)
+{
+    //- a mask selects fields inside of the sub-message, the cached encoding has all of them
+    if (stream.p_mask) [[unlikely]]
+        return serialize<mode>(stream, field, value.value());
+
+    //- memoized encoding, the sub-message is encoded only once
+    const auto encoded = value.encoded();
+    if (encoded.empty()) [[unlikely]]
+        return;
+
+    serialize_tag(stream, field, wire_type::length_delimited);
+    serialize_varint(stream, encoded.size());
+    stream.write(encoded.data(), encoded.size());
+}
+
+template <serialize_mode mode>
+void serialize(auto &stream, uint32_t field, const spb::detail::proto_field_stream_bytes auto &value)
+{
+    using stream_type = std::remove_cvref_t<decltype(stream)>;
+    //- chunks are read into a temporary buffer, they can't be referenced by iovecs
+    static_assert(!std::is_same_v<stream_type, ostream_iov>,
+                  "stream_bytes can't be serialized by serialize_iov");
+
+    if (value.empty())
+        return;
+
+    if constexpr (!stream_type::size_only && mode.max_size)
+        check_size(value.size(), mode.max_size);
+
+    serialize_tag(stream, field, wire_type::length_delimited);
+    serialize_varint(stream, value.size());
+
+    if constexpr (stream_type::size_only)
+    {
+        stream.write(nullptr, value.size());
+    }
+    else
+    {
+        std::byte buffer[4096];
+        for (auto size = value.size(); size > 0;)
+        {
+            const auto chunk = std::min(size, sizeof(buffer));
+            value.pull({buffer, chunk});
+            stream.write(buffer, chunk);
+            size -= chunk;
+        }
+    }
+}
+
+template <serialize_mode mode> auto serialize_size(const auto &value, const spb::field_mask *p_mask) -> size_t
+{
+    auto stream = ostream_size{.size = 0, .p_mask = p_mask};
     serialize<mode>(stream, value);
     return stream.size;
 }
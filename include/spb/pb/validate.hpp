@@ -0,0 +1,221 @@
+/***************************************************************************\
+* Name        : validate library for protobuf                               *
+* Description : protobuf validation without deserialization                *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+
+#pragma once
+
+#include "../concepts.h"
+#include "../utf8.h"
+#include "deserialize.hpp"
+#include "wire-types.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace spb::pb::detail
+{
+/**
+ * @brief throw if some required field was not found
+ *
+ * @param present bit for every required field found in the message
+ * @param required bit for every required field of the message
+ */
+inline void check_required(uint64_t present, uint64_t required)
+{
+    if (present != required) [[unlikely]]
+        throw std::runtime_error("missing required field");
+}
+
+/**
+ * @brief walk all fields of a message, `on_field(stream, tag)` is called for every field
+ *        for `wire_type::length_delimited` the stream is the field's sub-stream
+ */
+void validate_message(istream_buffer &stream, auto on_field)
+{
+    while (!stream.empty())
+    {
+        const auto tag = read_tag_or_eof(stream);
+        if (tag == tag_type::invalid)
+            return;
+
+        if (wire_type_from_tag(tag) == wire_type::length_delimited)
+        {
+            const auto size = read_varint<uint32_t>(stream);
+            auto substream  = stream.sub_stream(size);
+            on_field(substream, tag);
+            check_if_empty_or_throw(substream);
+        }
+        else
+        {
+            on_field(stream, tag);
+        }
+    }
+}
+
+template <serialize_mode mode, typename T> void validate(istream_buffer &stream, wire_type type);
+
+/**
+ * @brief validate one occurrence of a repeated field
+ *
+ * @param count number of elements found so far, checked against `max_count`
+ */
+template <serialize_mode mode, typename T>
+void validate_repeated(istream_buffer &stream, wire_type type, size_t &count)
+{
+    using value_type = typename T::value_type;
+
+    if constexpr (!spb::detail::proto_label_repeated<T>)
+    {
+        //- fixed size arrays are checked for their exact size
+        validate<mode, T>(stream, type);
+    }
+    else if constexpr (is_packed(mode.encoder))
+    {
+        check_wire_type_or_throw(type, wire_type::length_delimited);
+        while (!stream.empty())
+        {
+            if constexpr (mode.max_count)
+                check_size(++count, mode.max_count);
+
+            validate<reset_packed(mode), value_type>(stream, to_wire_type(mode.encoder));
+        }
+    }
+    else
+    {
+        if constexpr (mode.max_count)
+            check_size(++count, mode.max_count);
+
+        validate<mode, value_type>(stream, type);
+    }
+}
+
+template <serialize_mode mode, spb::detail::proto_map T>
+void validate_map(istream_buffer &stream, wire_type type)
+{
+    using key_type    = typename T::key_type;
+    using mapped_type = typename T::mapped_type;
+
+    constexpr auto key_encoder   = serialize_mode{.encoder = mode.encoder};
+    constexpr auto value_encoder = serialize_mode{.encoder = mode.encoder2};
+
+    check_wire_type_or_throw(type, wire_type::length_delimited);
+
+    auto key_defined   = false;
+    auto value_defined = false;
+    validate_message(stream,
+                     [&](istream_buffer &stream, tag_type tag)
+                     {
+                         const auto field_type = wire_type_from_tag(tag);
+                         switch (field_from_tag(tag))
+                         {
+                         case 1:
+                             validate<key_encoder, key_type>(stream, field_type);
+                             key_defined = true;
+                             return;
+                         case 2:
+                             validate<value_encoder, mapped_type>(stream, field_type);
+                             value_defined = true;
+                             return;
+                         default:
+                             throw std::runtime_error("invalid field");
+                         }
+                     });
+
+    if (!key_defined || !value_defined) [[unlikely]]
+        throw std::runtime_error("invalid map item");
+}
+
+/**
+ * @brief validate one field of type `T` without decoding it into `T`
+ *
+ * @param stream field's payload for `wire_type::length_delimited`, the message otherwise
+ * @param type field's wire type
+ */
+template <serialize_mode mode, typename T> void validate(istream_buffer &stream, wire_type type)
+{
+    if constexpr (spb::detail::proto_label_optional<T>)
+    {
+        validate<mode, typename T::value_type>(stream, type);
+    }
+    else if constexpr (requires { typename T::element_type; } && !spb::detail::proto_field_bytes<T>)
+    {
+        validate<mode, typename T::element_type>(stream, type);
+    }
+    else if constexpr (spb::detail::proto_field_raw<T> || spb::detail::proto_cached<T>)
+    {
+        validate<mode, typename T::message_type>(stream, type);
+    }
+    else if constexpr (spb::detail::proto_field_string<T> || spb::detail::proto_field_bytes<T> ||
+                       spb::detail::proto_field_stream_bytes<T>)
+    {
+        check_wire_type_or_throw(type, wire_type::length_delimited);
+        if constexpr (mode.max_size)
+            check_size(stream.size(), mode.max_size);
+
+        if constexpr (!spb::detail::proto_field_string_resizable<T> &&
+                      !spb::detail::proto_field_string_view<T> &&
+                      !spb::detail::proto_field_bytes_resizable<T> &&
+                      !spb::detail::proto_field_stream_bytes<T>)
+        {
+            if (stream.size() != T().size()) [[unlikely]]
+                throw std::runtime_error("invalid string size");
+        }
+        if constexpr (spb::detail::proto_field_string<T>)
+            spb::detail::utf8::validate(
+                std::string_view(reinterpret_cast<const char *>(stream.p_start), stream.size()));
+
+        stream.skip_or_throw(stream.size());
+    }
+    else if constexpr (spb::detail::proto_map<T>)
+    {
+        validate_map<mode, T>(stream, type);
+    }
+    else if constexpr (spb::detail::proto_label_repeated<T>)
+    {
+        auto count = size_t(0);
+        validate_repeated<mode, T>(stream, type, count);
+    }
+    else if constexpr (spb::detail::proto_message<T>)
+    {
+        check_wire_type_or_throw(type, wire_type::length_delimited);
+        //- generated by the sprotoc
+        validate_value(stream, std::type_identity<T>());
+    }
+    else if constexpr (spb::detail::proto_enum<T>)
+    {
+        if constexpr (!is_packed(mode.encoder))
+            check_wire_type_or_throw(type, wire_type::varint);
+
+        //- generated by the sprotoc
+        validate_value(stream, std::type_identity<T>());
+    }
+    else
+    {
+        //- scalars and fixed size arrays are decoded into a temporary on the stack
+        auto value = T();
+        deserialize<mode>(stream, value, type);
+    }
+}
+
+template <serialize_mode mode, typename T>
+void validate_bitfield(istream_buffer &stream, uint32_t bits, wire_type type)
+{
+    (void)deserialize_bitfield<mode, T>(stream, bits, type);
+}
+
+template <serialize_mode mode, size_t ordinal, typename T>
+void validate_variant(istream_buffer &stream, wire_type type)
+{
+    validate<mode, std::variant_alternative_t<ordinal, T>>(stream, type);
+}
+
+} // namespace spb::pb::detail
@@ -0,0 +1,127 @@
+/***************************************************************************\
+* Name        : stream bytes                                                *
+* Description : bytes field passed in chunks via user callbacks             *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace spb
+{
+/**
+ * @brief `bytes` field which is never kept in memory, use `(spb_opt).stream = true` to generate it
+ *        deserialize passes the payload in chunks to a sink as they arrive
+ *        serialize writes the declared number of bytes, pulled in chunks from a source
+ *
+ * @example `message.data.set_sink([&](std::span<const std::byte> chunk) { file.write(chunk); });`
+ *          `message.data.set_source(size, [&](std::span<std::byte> buffer) { return file.read(buffer); });`
+ */
+class stream_bytes
+{
+  public:
+    /**
+     * @brief called for every chunk of the payload during deserialize
+     */
+    using sink = std::function<void(std::span<const std::byte> chunk)>;
+
+    /**
+     * @brief called during serialize to fill `buffer`
+     *
+     * @return number of bytes copied into `buffer`, could be less than `buffer.size()`.
+     *         0 indicates end-of-file
+     */
+    using source = std::function<size_t(std::span<std::byte> buffer)>;
+
+    stream_bytes() = default;
+
+    explicit stream_bytes(sink on_chunk) : on_chunk_(std::move(on_chunk))
+    {
+    }
+
+    stream_bytes(size_t size, source on_read) : on_read_(std::move(on_read)), size_(size)
+    {
+    }
+
+    /**
+     * @brief set sink for deserialize, the received size is reset
+     */
+    void set_sink(sink on_chunk)
+    {
+        on_chunk_ = std::move(on_chunk);
+        size_     = 0;
+    }
+
+    /**
+     * @brief set source for serialize
+     *
+     * @param size declared size in bytes, the source has to provide exactly `size` bytes
+     * @param on_read source of the payload
+     */
+    void set_source(size_t size, source on_read)
+    {
+        on_read_ = std::move(on_read);
+        size_    = size;
+    }
+
+    /**
+     * @brief declared size (serialize) or number of received bytes (deserialize)
+     */
+    [[nodiscard]] auto size() const noexcept -> size_t
+    {
+        return size_;
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief pass a received chunk to the sink (used by deserialize)
+     *
+     * @throws std::runtime_error if there is no sink
+     */
+    void push(std::span<const std::byte> chunk)
+    {
+        if (!on_chunk_) [[unlikely]]
+            throw std::runtime_error("stream_bytes without sink");
+
+        on_chunk_(chunk);
+        size_ += chunk.size();
+    }
+
+    /**
+     * @brief fill the whole `buffer` from the source (used by serialize)
+     *
+     * @throws std::runtime_error if the source ends before the declared size
+     */
+    void pull(std::span<std::byte> buffer) const
+    {
+        if (!on_read_) [[unlikely]]
+            throw std::runtime_error("stream_bytes without source");
+
+        while (!buffer.empty())
+        {
+            const auto size = on_read_(buffer);
+            if (size == 0 || size > buffer.size()) [[unlikely]]
+                throw std::runtime_error("unexpected end of stream_bytes");
+
+            buffer = buffer.subspan(size);
+        }
+    }
+
+  private:
+    sink on_chunk_;
+    source on_read_;
+    size_t size_ = 0;
+};
+} // namespace spb
@@ -0,0 +1,95 @@
+/***************************************************************************\
+* Name        : streaming                                                   *
+* Description : per-element handlers for repeated fields                    *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+#pragma once
+
+#include "concepts.h"
+#include <span>
+#include <utility>
+
+namespace spb
+{
+/**
+ * @brief handler for elements of a repeated field, see `deserialize_streaming`
+ */
+template <typename Message, typename Container, typename Handler> struct element_handler
+{
+    Container Message::*p_member;
+    Handler handler;
+};
+
+/**
+ * @brief create handler for elements of a repeated field
+ *        every decoded element is passed (as rvalue) to `handler` and then removed from the field
+ *
+ * @param p_member repeated field of the message
+ * @param handler function called for every element
+ * @example `spb::on_element(&AddressBook::people, [](Person && person) { ... })`
+ */
+template <typename Message, spb::detail::proto_label_repeated Container, typename Handler>
+[[nodiscard]] auto on_element(Container Message::*p_member, Handler handler)
+    -> element_handler<Message, Container, Handler>
+{
+    return {p_member, std::move(handler)};
+}
+
+namespace detail
+{
+/**
+ * @brief type erased element handler bound to a container
+ */
+struct element_sink
+{
+    void *p_container;
+    void *p_handler;
+    void (*p_flush)(void *p_container, void *p_handler);
+};
+
+/**
+ * @brief pass all elements of the container to the handler and clear the container
+ */
+template <typename Container, typename Handler> void flush_elements(Container &container, Handler &handler)
+{
+    for (auto &&element : container)
+        handler(std::move(element));
+
+    container.clear();
+}
+
+template <typename Message, typename Container, typename Handler>
+auto make_element_sink(Message &message, element_handler<Message, Container, Handler> &handler)
+    -> element_sink
+{
+    return {&(message.*handler.p_member), &handler.handler, [](void *p_container, void *p_handler)
+            { flush_elements(*static_cast<Container *>(p_container), *static_cast<Handler *>(p_handler)); }};
+}
+
+/**
+ * @brief flush all containers with a handler
+ */
+inline void flush_elements(std::span<const element_sink> sinks)
+{
+    for (const auto &sink : sinks)
+        sink.p_flush(sink.p_container, sink.p_handler);
+}
+
+/**
+ * @brief flush the container if it has a handler
+ */
+inline void flush_elements(std::span<const element_sink> sinks, const void *p_container)
+{
+    for (const auto &sink : sinks)
+    {
+        if (sink.p_container == p_container)
+            return sink.p_flush(sink.p_container, sink.p_handler);
+    }
+}
+
+} // namespace detail
+} // namespace spb
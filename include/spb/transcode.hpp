@@ -0,0 +1,738 @@
+/***************************************************************************\
+* Name        : transcode                                                   *
+* Description : direct protobuf <-> JSON conversion without the C++ structs *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+#pragma once
+
+#include "concepts.h"
+#include "json.hpp"
+#include "pb.hpp"
+#include "utf8.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <spb/io/io.hpp>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace spb::transcode
+{
+/**
+ * @brief generated field dispatch for a message, use `(spb_msgopt).transcode = true` to generate it
+ *        messages without a transcoder can still be transcoded as sub-messages, they are decoded into
+ *        a temporary struct
+ */
+template <typename Message> struct transcoder
+{
+};
+
+namespace detail
+{
+using pb_istream   = spb::pb::detail::istream_buffer;
+using json_ostream = spb::json::detail::ostream_writer;
+using json_istream = spb::json::detail::istream_buffer;
+
+//- generated key dispatch refers to `detail::key_hash` (`detail::djb2_hash` in older generated code)
+using spb::json::detail::djb2_hash;
+using spb::json::detail::key_hash;
+
+/**
+ * @brief state of a message being written as JSON
+ *        elements of a repeated (or map) field are grouped into one JSON array (or object)
+ *        while they come one after another on the wire
+ *        every field is written once, a field found again after it was closed would be a duplicate key
+ */
+struct pb_to_json_state
+{
+    uint32_t open_field = 0;
+    char close_char     = 0;
+    //- fields 1..64 (the common case) in a bitset, the rest in a vector
+    uint64_t written_low = 0;
+    std::vector<uint32_t> written_high;
+};
+
+template <typename Message>
+concept has_pb_to_json = requires(pb_istream &in, json_ostream &out, spb::pb::detail::tag_type tag,
+                                  pb_to_json_state &state) {
+    { transcoder<Message>::pb_to_json_field(in, out, tag, state) } -> std::same_as<bool>;
+};
+
+inline void close_open_field(json_ostream &out, pb_to_json_state &state)
+{
+    if (state.open_field == 0)
+        return;
+
+    out.write(state.close_char);
+    out.put_comma    = true;
+    state.open_field = 0;
+}
+
+/**
+ * @brief mark `field` as written
+ *
+ * @throws std::runtime_error if the field was written already (interleaved repeated elements or
+ *         a singular field repeated on the wire)
+ */
+inline void mark_written(pb_to_json_state &state, uint32_t field)
+{
+    auto written = false;
+    if (field - 1 < 64)
+    {
+        const auto bit = uint64_t(1) << (field - 1);
+        written        = (state.written_low & bit) != 0;
+        state.written_low |= bit;
+    }
+    else
+    {
+        written = std::find(state.written_high.begin(), state.written_high.end(), field) !=
+            state.written_high.end();
+        if (!written)
+            state.written_high.push_back(field);
+    }
+    if (written) [[unlikely]]
+        throw std::runtime_error("duplicate field (JSON key)");
+}
+
+inline void begin_field(json_ostream &out, pb_to_json_state &state, uint32_t field, std::string_view name)
+{
+    close_open_field(out, state);
+    mark_written(state, field);
+    spb::json::detail::serialize_key(out, name);
+}
+
+/**
+ * @brief open the JSON array (or object) for a repeated (or map) field if it is not open already
+ */
+inline void begin_element(json_ostream &out, pb_to_json_state &state, uint32_t field, std::string_view name,
+                          char open_char, char close_char)
+{
+    if (state.open_field != field)
+    {
+        begin_field(out, state, field, name);
+        out.write(open_char);
+        out.put_comma    = false;
+        state.open_field = field;
+        state.close_char = close_char;
+    }
+}
+
+template <typename Message> void pb_to_json_message(pb_istream &in, json_ostream &out);
+
+template <spb::pb::detail::serialize_mode mode, typename T>
+void pb_to_json_value(pb_istream &in, json_ostream &out, spb::pb::detail::wire_type type)
+{
+    using namespace spb::pb::detail;
+
+    if constexpr (spb::detail::proto_field_raw<T> || spb::detail::proto_cached<T>)
+    {
+        pb_to_json_value<mode, typename T::message_type>(in, out, type);
+    }
+    else if constexpr (spb::detail::proto_field_bytes<T> || spb::detail::proto_field_stream_bytes<T>)
+    {
+        check_wire_type_or_throw(type, wire_type::length_delimited);
+        const auto bytes = std::span(reinterpret_cast<const std::byte *>(in.p_start), in.size());
+        out.write('"');
+        spb::json::detail::base64_encode(out, bytes);
+        out.write('"');
+        in.skip_or_throw(bytes.size());
+    }
+    else if constexpr (spb::detail::proto_field_string<T>)
+    {
+        check_wire_type_or_throw(type, wire_type::length_delimited);
+        //- escaped straight from the input, no temporary string
+        const auto value = std::string_view(reinterpret_cast<const char *>(in.p_start), in.size());
+        spb::detail::utf8::validate(value);
+        spb::json::detail::serialize<spb::json::detail::field_attributes{}>(out, value);
+        in.skip_or_throw(value.size());
+    }
+    else if constexpr (spb::detail::proto_message<T> && has_pb_to_json<T>)
+    {
+        check_wire_type_or_throw(type, wire_type::length_delimited);
+        pb_to_json_message<T>(in, out);
+    }
+    else
+    {
+        //- scalars, enums and messages without a transcoder
+        auto value = T{};
+        deserialize<mode>(in, value, type);
+        spb::json::detail::serialize<spb::json::detail::field_attributes{}>(out, value);
+    }
+}
+
+/**
+ * @brief write a map entry as `"key":value` into the open JSON object
+ */
+template <spb::pb::detail::serialize_mode mode, typename Map>
+void pb_to_json_map_entry(pb_istream &in, json_ostream &out, spb::pb::detail::wire_type type)
+{
+    using key_type = typename Map::key_type;
+
+    //- the entry is small and its key can come after its value, so it is decoded first
+    auto entry = Map{};
+    spb::pb::detail::deserialize<mode>(in, entry, type);
+    for (const auto &[key, value] : entry)
+    {
+        spb::json::detail::put_comma_if_needed(out);
+        out.write('"');
+        if constexpr (spb::detail::proto_field_string<key_type>)
+            spb::json::detail::write_escaped(out, std::string_view(key.data(), key.size()));
+        else
+            spb::json::detail::serialize<spb::json::detail::field_attributes{}>(out, key);
+        spb::json::detail::write_string(out, R"(":)");
+        out.put_comma = false;
+        spb::json::detail::serialize<spb::json::detail::field_attributes{}>(out, value);
+        out.put_comma = true;
+    }
+}
+
+/**
+ * @brief write one occurrence of a field (as found on the wire) as JSON
+ *
+ * @param in field's payload for `length_delimited`, the message otherwise
+ * @param tag field's tag
+ * @param name field's JSON name
+ */
+template <spb::pb::detail::serialize_mode mode, typename T>
+void pb_to_json_field(pb_istream &in, json_ostream &out, spb::pb::detail::tag_type tag, std::string_view name,
+                      pb_to_json_state &state)
+{
+    using namespace spb::pb::detail;
+
+    const auto type  = wire_type_from_tag(tag);
+    const auto field = field_from_tag(tag);
+
+    if constexpr (spb::detail::proto_label_optional<T>)
+    {
+        pb_to_json_field<mode, typename T::value_type>(in, out, tag, name, state);
+    }
+    else if constexpr (requires { typename T::element_type; } && !spb::detail::proto_field_bytes<T>)
+    {
+        pb_to_json_field<mode, typename T::element_type>(in, out, tag, name, state);
+    }
+    else if constexpr (spb::detail::proto_map<T>)
+    {
+        begin_element(out, state, field, name, '{', '}');
+        pb_to_json_map_entry<mode, T>(in, out, type);
+    }
+    else if constexpr ((spb::detail::proto_label_repeated<T> || spb::detail::proto_label_repeated_fixed_size<T>) &&
+                       !spb::detail::proto_field_bytes<T> && !spb::detail::proto_field_string<T>)
+    {
+        using value_type = typename T::value_type;
+
+        begin_element(out, state, field, name, '[', ']');
+        if constexpr (is_packed(mode.encoder))
+        {
+            check_wire_type_or_throw(type, wire_type::length_delimited);
+            while (!in.empty())
+            {
+                spb::json::detail::put_comma_if_needed(out);
+                pb_to_json_value<reset_packed(mode), value_type>(in, out, to_wire_type(mode.encoder));
+            }
+        }
+        else
+        {
+            spb::json::detail::put_comma_if_needed(out);
+            pb_to_json_value<mode, value_type>(in, out, type);
+        }
+    }
+    else
+    {
+        //- empty strings and bytes are omitted, same as `spb::json::serialize`
+        if constexpr (spb::detail::proto_field_string<T> || spb::detail::proto_field_bytes<T>)
+        {
+            if (type == wire_type::length_delimited && in.empty())
+            {
+                close_open_field(out, state);
+                mark_written(state, field);
+                return;
+            }
+        }
+        begin_field(out, state, field, name);
+        pb_to_json_value<mode, T>(in, out, type);
+    }
+}
+
+/**
+ * @brief write the whole message `{...}` from its protobuf fields
+ */
+template <typename Message> void pb_to_json_message(pb_istream &in, json_ostream &out)
+{
+    using namespace spb::pb::detail;
+
+    out.write('{');
+    out.put_comma = false;
+
+    auto state = pb_to_json_state{};
+    while (!in.empty())
+    {
+        const auto tag = read_tag_or_eof(in);
+        if (tag == tag_type::invalid)
+            break;
+
+        const auto type = wire_type_from_tag(tag);
+        if (type == wire_type::length_delimited)
+        {
+            const auto size = read_varint<uint32_t>(in);
+            auto substream  = in.sub_stream(size);
+            if (!transcoder<Message>::pb_to_json_field(substream, out, tag, state))
+                skip(substream, type);
+            check_if_empty_or_throw(substream);
+        }
+        else if (!transcoder<Message>::pb_to_json_field(in, out, tag, state))
+        {
+            skip(in, type);
+        }
+    }
+    close_open_field(out, state);
+
+    out.write('}');
+    out.put_comma = true;
+}
+/**
+ * @brief protobuf output of `json_to_pb`
+ *        length of a length delimited field is not known until the field is closed, so the field is
+ *        pushed onto a stack with one byte reserved for its length and the length is back-patched
+ *        (the payload is moved only if the length needs more than one byte)
+ *        the buffer is passed to `on_write` after each top-level field, so it holds at most one of them
+ */
+struct pb_ostream
+{
+    spb::io::writer on_write;
+    size_t size = 0;
+    std::vector<std::byte> buffer;
+
+    explicit pb_ostream(spb::io::writer writer) : on_write(writer)
+    {
+    }
+
+    void write(uint8_t byte)
+    {
+        buffer.push_back(std::byte(byte));
+    }
+
+    void write(const void *data, size_t size)
+    {
+        const auto *p_data = static_cast<const std::byte *>(data);
+        buffer.insert(buffer.end(), p_data, p_data + size);
+    }
+
+    void begin_length_delimited(uint32_t field)
+    {
+        const auto tag_offset = buffer.size();
+        spb::pb::detail::serialize_tag(*this, field, spb::pb::detail::wire_type::length_delimited);
+        buffer.emplace_back();
+        open_fields.push_back({.tag_offset = tag_offset, .payload_offset = buffer.size()});
+    }
+
+    void end_length_delimited()
+    {
+        const auto field = open_fields.back();
+        open_fields.pop_back();
+
+        const auto size = buffer.size() - field.payload_offset;
+        if (size == 0)
+        {
+            //- empty fields are omitted, same as `spb::pb::serialize`
+            buffer.resize(field.tag_offset);
+            return;
+        }
+
+        const auto length_size = spb::pb::detail::serialize_varint_size(size);
+        if (length_size > 1) [[unlikely]]
+            buffer.insert(buffer.begin() + ptrdiff_t(field.payload_offset), length_size - 1, std::byte());
+
+        auto length = spb::pb::detail::ostream_buffer(buffer.data() + field.payload_offset - 1);
+        spb::pb::detail::serialize_varint(length, size);
+    }
+
+    /**
+     * @brief write via `spb::pb::detail::serialize` functions, the generated code has overloads only for the
+     *        library's streams, so it is sized by `ostream_size` and written by `ostream_buffer`
+     *
+     * @param serialize_to function called with both streams
+     */
+    void serialize(auto serialize_to)
+    {
+        auto size_stream = spb::pb::detail::ostream_size{.size = 0};
+        serialize_to(size_stream);
+
+        const auto offset = buffer.size();
+        buffer.resize(offset + size_stream.size);
+        auto stream = spb::pb::detail::ostream_buffer(buffer.data() + offset);
+        serialize_to(stream);
+    }
+
+    /**
+     * @brief pass the buffer to `on_write` if no field is open (lengths of open fields are not known yet)
+     */
+    void flush()
+    {
+        if (!open_fields.empty() || buffer.empty())
+            return;
+
+        on_write(buffer.data(), buffer.size());
+        size += buffer.size();
+        buffer.clear();
+    }
+
+    /**
+     * @brief payload of the innermost open field
+     */
+    [[nodiscard]] auto payload() const noexcept -> std::span<const std::byte>
+    {
+        return std::span(buffer).subspan(open_fields.back().payload_offset);
+    }
+
+  private:
+    struct open_field
+    {
+        size_t tag_offset;
+        size_t payload_offset;
+    };
+    std::vector<open_field> open_fields;
+};
+
+/**
+ * @brief string (or bytes) appended at the end of the output, JSON strings are unescaped (and base64 is
+ *        decoded) straight into the protobuf output
+ */
+template <typename T> struct pb_appender
+{
+    using value_type = T;
+
+    std::vector<std::byte> &buffer;
+    size_t offset;
+
+    [[nodiscard]] auto data() noexcept -> T *
+    {
+        return reinterpret_cast<T *>(buffer.data() + offset);
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t
+    {
+        return buffer.size() - offset;
+    }
+    [[nodiscard]] auto begin() noexcept -> T *
+    {
+        return data();
+    }
+    [[nodiscard]] auto end() noexcept -> T *
+    {
+        return data() + size();
+    }
+    void resize(size_t size)
+    {
+        buffer.resize(offset + size);
+    }
+    void clear()
+    {
+        resize(0);
+    }
+    void append(const char *p_data, size_t size)
+    {
+        const auto *p_bytes = reinterpret_cast<const std::byte *>(p_data);
+        buffer.insert(buffer.end(), p_bytes, p_bytes + size);
+    }
+};
+
+template <typename Message>
+concept has_json_to_pb = requires(json_istream &in, pb_ostream &out) {
+    { transcoder<Message>::json_to_pb_field(in, out) } -> std::same_as<void>;
+};
+
+template <typename Message> void json_to_pb_message(json_istream &in, pb_ostream &out);
+
+/**
+ * @brief write one JSON value as a protobuf field (with tag)
+ */
+template <spb::pb::detail::serialize_mode mode, spb::json::detail::field_attributes attributes, typename T>
+void json_to_pb_value(json_istream &in, pb_ostream &out, uint32_t field)
+{
+    if constexpr (spb::detail::proto_field_raw<T> || spb::detail::proto_cached<T>)
+    {
+        json_to_pb_value<mode, attributes, typename T::message_type>(in, out, field);
+    }
+    else if constexpr (spb::detail::proto_field_string_resizable<T> ||
+                       spb::detail::proto_field_string_view<T>)
+    {
+        out.begin_length_delimited(field);
+        auto value = pb_appender<char>{out.buffer, out.buffer.size()};
+        spb::json::detail::deserialize<attributes>(in, value);
+        const auto payload = out.payload();
+        spb::detail::utf8::validate(
+            std::string_view(reinterpret_cast<const char *>(payload.data()), payload.size()));
+        out.end_length_delimited();
+    }
+    else if constexpr (spb::detail::proto_field_bytes_resizable<T> || spb::detail::proto_field_stream_bytes<T>)
+    {
+        using namespace std::literals;
+
+        if (in.consume_and_skip_white_space("null"sv))
+            return;
+
+        out.begin_length_delimited(field);
+        auto value = pb_appender<std::byte>{out.buffer, out.buffer.size()};
+        spb::json::detail::base64_decode_string(value, in, attributes.max_size);
+        out.end_length_delimited();
+    }
+    else if constexpr (spb::detail::proto_message<T> && has_json_to_pb<T>)
+    {
+        out.begin_length_delimited(field);
+        json_to_pb_message<T>(in, out);
+        out.end_length_delimited();
+    }
+    else
+    {
+        //- scalars, enums and messages without a transcoder
+        auto value = T{};
+        spb::json::detail::deserialize<attributes>(in, value);
+        out.serialize([&](auto &stream) { spb::pb::detail::serialize<mode>(stream, field, value); });
+    }
+}
+
+/**
+ * @brief write one JSON array element into a packed field (without tag)
+ */
+template <spb::pb::detail::serialize_mode mode, spb::json::detail::field_attributes attributes, typename T>
+void json_to_pb_packed_element(json_istream &in, pb_ostream &out)
+{
+    auto value = T{};
+    spb::json::detail::deserialize<attributes>(in, value);
+    out.serialize([&](auto &stream) { spb::pb::detail::serialize<mode>(stream, value); });
+}
+
+template <spb::pb::detail::serialize_mode mode, spb::json::detail::field_attributes attributes, typename T>
+void json_to_pb_array(json_istream &in, pb_ostream &out, uint32_t field)
+{
+    using value_type = typename T::value_type;
+
+    if (!in.consume_and_skip_white_space('[')) [[unlikely]]
+        throw std::runtime_error("expecting '['");
+
+    if (in.consume_and_skip_white_space(']'))
+        return;
+
+    if constexpr (is_packed(mode.encoder))
+        out.begin_length_delimited(field);
+
+    auto count = size_t(0);
+    do
+    {
+        if constexpr (attributes.max_count)
+            spb::json::detail::check_size(++count, attributes.max_count);
+
+        if constexpr (is_packed(mode.encoder))
+            json_to_pb_packed_element<mode, attributes, value_type>(in, out);
+        else
+            json_to_pb_value<mode, attributes, value_type>(in, out, field);
+    } while (in.consume_and_skip_white_space(','));
+
+    if (!in.consume_and_skip_white_space(']')) [[unlikely]]
+        throw std::runtime_error("expecting ']'");
+
+    if constexpr (is_packed(mode.encoder))
+        out.end_length_delimited();
+}
+
+template <spb::pb::detail::serialize_mode mode, spb::json::detail::field_attributes attributes, typename Map>
+void json_to_pb_map(json_istream &in, pb_ostream &out, uint32_t field)
+{
+    if (!in.consume_and_skip_white_space('{')) [[unlikely]]
+        throw std::runtime_error("expecting '{'");
+
+    if (in.consume_and_skip_white_space('}'))
+        return;
+
+    do
+    {
+        //- the entry is written only when both key and value are known
+        auto key = typename Map::key_type();
+        spb::json::detail::deserialize_map_key<attributes>(in, key);
+        if (!in.consume_and_skip_white_space(':')) [[unlikely]]
+            throw std::runtime_error("expecting ':'");
+
+        auto value = typename Map::mapped_type();
+        spb::json::detail::deserialize<attributes>(in, value);
+        out.serialize([&](auto &stream) { spb::pb::detail::serialize_map_entry<mode>(stream, field, key, value); });
+    } while (in.consume_and_skip_white_space(','));
+
+    if (!in.consume_and_skip_white_space('}')) [[unlikely]]
+        throw std::runtime_error("expecting '}'");
+}
+
+/**
+ * @brief write the value of a JSON key as protobuf field(s)
+ *
+ * @param in JSON positioned at the value
+ * @param field field number
+ */
+template <spb::pb::detail::serialize_mode mode, spb::json::detail::field_attributes attributes, typename T>
+void json_to_pb_field(json_istream &in, pb_ostream &out, uint32_t field)
+{
+    using namespace std::literals;
+
+    if constexpr (spb::detail::proto_label_optional<T>)
+    {
+        if (!in.consume_and_skip_white_space("null"sv))
+            json_to_pb_field<mode, attributes, typename T::value_type>(in, out, field);
+    }
+    else if constexpr (requires { typename T::element_type; } && !spb::detail::proto_field_bytes<T>)
+    {
+        if (!in.consume_and_skip_white_space("null"sv))
+            json_to_pb_field<mode, attributes, typename T::element_type>(in, out, field);
+    }
+    else if constexpr (spb::detail::proto_map<T>)
+    {
+        if (!in.consume_and_skip_white_space("null"sv))
+            json_to_pb_map<mode, attributes, T>(in, out, field);
+    }
+    else if constexpr (spb::detail::proto_label_repeated<T>)
+    {
+        if (!in.consume_and_skip_white_space("null"sv))
+            json_to_pb_array<mode, attributes, T>(in, out, field);
+    }
+    else
+    {
+        json_to_pb_value<mode, attributes, T>(in, out, field);
+    }
+}
+
+template <spb::pb::detail::serialize_mode mode, spb::json::detail::field_attributes attributes, typename T>
+void json_to_pb_bitfield(json_istream &in, pb_ostream &out, uint32_t field, uint32_t bits)
+{
+    const auto value = spb::json::detail::deserialize_bitfield<attributes, T>(in, bits);
+    out.serialize([&](auto &stream) { spb::pb::detail::serialize<mode>(stream, field, value); });
+}
+
+/**
+ * @brief write the whole JSON object `{...}` as protobuf fields
+ */
+template <typename Message> void json_to_pb_message(json_istream &in, pb_ostream &out)
+{
+    if (!in.consume_and_skip_white_space('{')) [[unlikely]]
+        throw std::runtime_error("expecting '{'");
+
+    if (in.consume_and_skip_white_space('}'))
+        return;
+
+    const auto parent_key = in.next_key;
+    in.next_key           = 0;
+    for (;;)
+    {
+        transcoder<Message>::json_to_pb_field(in, out);
+        //- no-op for sub-messages, their field is still open
+        out.flush();
+
+        if (in.consume_and_skip_white_space(','))
+            continue;
+
+        if (in.consume_and_skip_white_space('}'))
+            break;
+
+        throw std::runtime_error("expecting '}' or ','");
+    }
+    in.next_key = parent_key;
+}
+} // namespace detail
+
+/**
+ * @brief convert protobuf directly to JSON, fields are written as they are read from the wire
+ *        strings are escaped straight from the input and no `Message` is built
+ *        elements of a repeated field are expected one after another (as every encoder writes them)
+ *
+ * @param[in] protobuf serialized `Message`
+ * @param[in] on_write function for handling the writes
+ * @return JSON size in bytes
+ * @throws std::runtime_error on error, interleaved repeated elements and a singular field found more than
+ *         once are errors (they would be duplicate JSON keys)
+ * @example `spb::transcode::pb_to_json< Person >( protobuf, writer );`
+ */
+template <typename Message> size_t pb_to_json(const spb::size_container auto &protobuf, spb::io::writer on_write)
+{
+    static_assert(detail::has_pb_to_json<Message>, "use (spb_msgopt).transcode = true for the message");
+
+    auto in  = detail::pb_istream(reinterpret_cast<const uint8_t *>(protobuf.data()), protobuf.size());
+    auto out = detail::json_ostream(on_write);
+    detail::pb_to_json_message<Message>(in, out);
+    return out.size;
+}
+
+/**
+ * @brief convert protobuf directly to JSON
+ *
+ * @param[in] protobuf serialized `Message`
+ * @return JSON
+ * @throws std::runtime_error on error
+ * @example `auto json = spb::transcode::pb_to_json< Person >( protobuf );`
+ */
+template <typename Message, spb::resizable_container Container = std::string>
+[[nodiscard]] auto pb_to_json(const spb::size_container auto &protobuf) -> Container
+{
+    static_assert(sizeof(*std::declval<Container>().data()) == sizeof(char));
+
+    auto result = Container();
+    pb_to_json<Message>(protobuf,
+                        [&result](const void *p_data, size_t size)
+                        {
+                            const auto offset = result.size();
+                            result.resize(offset + size);
+                            memcpy(result.data() + offset, p_data, size);
+                        });
+    return result;
+}
+
+/**
+ * @brief convert JSON directly to protobuf, fields are written as they are parsed
+ *        strings are unescaped and base64 is decoded straight into the output and no `Message` is built
+ *        fields are written in the JSON order, each top-level field is passed to `on_write` once complete
+ *
+ * @param[in] json serialized `Message`
+ * @param[in] on_write function for handling the writes
+ * @return protobuf size in bytes
+ * @throws std::runtime_error on error, fields before the error are already written
+ * @example `spb::transcode::json_to_pb< Person >( json, writer );`
+ */
+template <typename Message> size_t json_to_pb(const spb::size_container auto &json, spb::io::writer on_write)
+{
+    static_assert(detail::has_json_to_pb<Message>, "use (spb_msgopt).transcode = true for the message");
+
+    auto in  = detail::json_istream(json.data(), json.size());
+    auto out = detail::pb_ostream(on_write);
+    detail::json_to_pb_message<Message>(in, out);
+    out.flush();
+    return out.size;
+}
+
+/**
+ * @brief convert JSON directly to protobuf
+ *
+ * @param[in] json serialized `Message`
+ * @return protobuf
+ * @throws std::runtime_error on error
+ * @example `auto protobuf = spb::transcode::json_to_pb< Person >( json );`
+ */
+template <typename Message, spb::resizable_container Container = std::string>
+[[nodiscard]] auto json_to_pb(const spb::size_container auto &json) -> Container
+{
+    static_assert(sizeof(*std::declval<Container>().data()) == sizeof(std::byte));
+
+    auto result = Container();
+    json_to_pb<Message>(json,
+                        [&result](const void *p_data, size_t size)
+                        {
+                            const auto offset = result.size();
+                            result.resize(offset + size);
+                            memcpy(result.data() + offset, p_data, size);
+                        });
+    return result;
+}
+} // namespace spb::transcode
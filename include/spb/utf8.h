@@ -22,7 +22,8 @@ namespace spb::detail::utf8
 // Copyright (c) 2008-2009 Bjoern Hoehrmann <bjoern@hoehrmann.de>
 // See http://bjoern.hoehrmann.de/utf-8/decoder/dfa/ for details.
 
-constexpr uint8_t ok = 0;
+constexpr uint8_t ok     = 0;
+constexpr uint8_t reject = 1;
 
 inline uint32_t decode_point(uint32_t *state, uint32_t *codep, uint8_t byte)
 {
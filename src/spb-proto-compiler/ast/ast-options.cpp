@@ -206,6 +206,33 @@ void convert_spb_options(const proto_file &file, proto_attributes &attributes, c
 
     if (auto value = option_value_int<uint32_t>(file, {opt_name, "max_count"}, options); value.has_value())
         attributes.max_count = value;
+
+    if (auto value = option_value_bool(file, {opt_name, "raw"}, options); value.has_value())
+        attributes.raw = *value;
+
+    if (auto value = option_value_bool(file, {opt_name, "cached"}, options); value.has_value())
+        attributes.cached = *value;
+
+    if (auto value = option_value_bool(file, {opt_name, "stream"}, options); value.has_value())
+        attributes.stream = *value;
+
+    if (auto value = option_value_bool(file, {opt_name, "unknown_fields"}, options); value.has_value())
+        attributes.unknown_fields = value;
+
+    if (auto value = option_value_bool(file, {opt_name, "builder"}, options); value.has_value())
+        attributes.builder = value;
+
+    if (auto value = option_value_bool(file, {opt_name, "transcode"}, options); value.has_value())
+        attributes.transcode = value;
+
+    if (auto value = option_value_bool(file, {opt_name, "iov"}, options); value.has_value())
+        attributes.iov = value;
+
+    if (auto value = option_value_bool(file, {opt_name, "chain"}, options); value.has_value())
+        attributes.chain = value;
+
+    if (auto value = option_value_bool(file, {opt_name, "trusted"}, options); value.has_value())
+        attributes.trusted = value;
 }
 void convert_spb_options(const proto_file &file, proto_attributes &attributes, const proto_options &options,
                          option_type type, bool legacy)
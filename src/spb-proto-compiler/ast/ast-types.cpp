@@ -307,6 +307,20 @@ void resolve_types(const search_ctx &self, proto_field &field)
 
     field.type     = type;
     field.bit_type = bit_type;
+
+    if (field.attributes.stream)
+    {
+        if (field.type != proto_field::Type::BYTES)
+            throw_parse_error(self.file, field.type_name.proto_name,
+                              "option `stream` can be used only for bytes");
+
+        if (field.label == proto_field::Label::REPEATED)
+            throw_parse_error(self.file, field.type_name.proto_name,
+                              "option `stream` can't be used for repeated fields");
+
+        //- the callbacks are set by the user, so the field can't be wrapped in std::optional
+        field.label = proto_field::Label::NONE;
+    }
 }
 
 void resolve_types(const search_ctx &self, proto_map &map)
@@ -319,6 +333,9 @@ void resolve_types(const search_ctx &self, proto_oneof &oneof)
 {
     for (auto &field : oneof.fields)
     {
+        if (field.attributes.stream)
+            throw_parse_error(self.file, field.name.proto_name, "option `stream` can't be used in oneof");
+
         resolve_types(self, field);
     }
 }
@@ -361,6 +378,36 @@ auto is_packed_array(const proto_file &file, const proto_field &field) -> bool
     return field.attributes.packed.value_or(file.syntax.version >= 3);
 }
 
+auto has_unknown_fields(const proto_file &file, const proto_message &message) -> bool
+{
+    return message.attributes.unknown_fields.value_or(file.attributes.unknown_fields.value_or(false));
+}
+
+auto has_builder(const proto_file &file, const proto_message &message) -> bool
+{
+    return message.attributes.builder.value_or(file.attributes.builder.value_or(false));
+}
+
+auto has_transcoder(const proto_file &file, const proto_message &message) -> bool
+{
+    return message.attributes.transcode.value_or(file.attributes.transcode.value_or(false));
+}
+
+auto has_iov(const proto_file &file, const proto_message &message) -> bool
+{
+    return message.attributes.iov.value_or(file.attributes.iov.value_or(false));
+}
+
+auto has_chain(const proto_file &file, const proto_message &message) -> bool
+{
+    return message.attributes.chain.value_or(file.attributes.chain.value_or(false));
+}
+
+auto has_trusted(const proto_file &file, const proto_message &message) -> bool
+{
+    return message.attributes.trusted.value_or(file.attributes.trusted.value_or(false));
+}
+
 auto is_scalar(const proto_field::Type &type) -> bool
 {
     switch (type)
@@ -391,6 +438,16 @@ auto is_scalar(const proto_field::Type &type) -> bool
     return false;
 }
 
+auto is_required(const proto_field &field) -> bool
+{
+    if (field.label != proto_field::Label::NONE || field.attributes.stream)
+        return false;
+
+    return field.type == proto_field::Type::ENUM ||
+           (is_scalar(field.type) && field.type != proto_field::Type::STRING &&
+            field.type != proto_field::Type::BYTES);
+}
+
 void resolve_types(proto_file &file)
 {
     auto ctx = search_ctx{
@@ -15,6 +15,14 @@
 
 [[nodiscard]] auto is_scalar(const proto_field::Type &type) -> bool;
 [[nodiscard]] auto is_packed_array(const proto_file &file, const proto_field &field) -> bool;
+[[nodiscard]] auto has_unknown_fields(const proto_file &file, const proto_message &message) -> bool;
+[[nodiscard]] auto has_builder(const proto_file &file, const proto_message &message) -> bool;
+[[nodiscard]] auto has_transcoder(const proto_file &file, const proto_message &message) -> bool;
+[[nodiscard]] auto has_iov(const proto_file &file, const proto_message &message) -> bool;
+[[nodiscard]] auto has_chain(const proto_file &file, const proto_message &message) -> bool;
+[[nodiscard]] auto has_trusted(const proto_file &file, const proto_message &message) -> bool;
+//- required field which is always serialized (empty strings, bytes and messages are omitted on the wire)
+[[nodiscard]] auto is_required(const proto_field &field) -> bool;
 
 /**
  * @brief resolve types in a proto file
@@ -90,4 +90,32 @@ struct proto_attributes
 
     // packed attribute for an array or message
     std::optional<bool> packed;
+
+    // keep message field pre-encoded as `spb::pb::raw<$>` (field option only)
+    bool raw = false;
+
+    // keep message field in `spb::cached<$>` with memoized encoding (field option only)
+    bool cached = false;
+
+    // pass `bytes` field in chunks via `spb::stream_bytes` callbacks (field option only)
+    bool stream = false;
+
+    // preserve unknown fields in the `unknown_fields` member of a message
+    // and write them back (verbatim) on serialize
+    std::optional<bool> unknown_fields;
+
+    // generate streaming `spb::pb::builder<$>` for a message
+    std::optional<bool> builder;
+
+    // generate `spb::transcode::transcoder<$>` for direct protobuf <-> JSON conversion of a message
+    std::optional<bool> transcode;
+
+    // generate `serialize_value` for `spb::pb::serialize_iov` for a message
+    std::optional<bool> iov;
+
+    // generate `deserialize_value` for `spb::pb::deserialize` from a chain of segments for a message
+    std::optional<bool> chain;
+
+    // generate `deserialize_value` for `spb::pb::deserialize` with `.trusted = true` for a message
+    std::optional<bool> trusted;
 };
@@ -12,6 +12,7 @@
 #include "header.h"
 #include "pb/dumper.h"
 #include "json/dumper.h"
+#include "transcode/dumper.h"
 
 void dump_cpp_header(const proto_file &file, std::ostream &stream)
 {
@@ -20,6 +21,7 @@ void dump_cpp_header(const proto_file &file, std::ostream &stream)
         dump_cpp_definitions(file, stream);
         dump_pb_header(file, stream);
         dump_json_header(file, stream);
+        dump_transcode_header(file, stream);
     }
     catch (const std::exception &e)
     {
@@ -33,6 +35,7 @@ void dump_cpp(const proto_file &file, const std::filesystem::path &header_file,
     {
         dump_pb_cpp(file, header_file, file_stream);
         dump_json_cpp(file, header_file, file_stream);
+        dump_transcode_cpp(file, header_file, file_stream);
     }
     catch (const std::exception &e)
     {
@@ -10,6 +10,7 @@
 
 #include "header.h"
 #include "../parser/char_stream.h"
+#include "ast/ast-types.h"
 #include "ast/proto-common.h"
 #include "ast/proto-field.h"
 #include "ast/proto-file.h"
@@ -34,9 +35,14 @@ struct std_includes
     bool array;
     bool map;
     bool string;
+    bool string_view;
     bool variant;
     bool optional;
     bool memory;
+    bool cached;
+    bool stream_bytes;
+    bool json_string;
+    bool transcode;
 };
 
 void dump_comment(std::ostream &stream, const proto_comment &comment)
@@ -248,6 +254,28 @@ auto convert_to_ctype(const proto_file &file, const proto_field &field, const pr
         }
     }
 
+    if (field.attributes.raw)
+    {
+        if (field.type != proto_field::Type::MESSAGE)
+            throw_parse_error(file, field.type_name.proto_name, "option `raw` can be used only for messages");
+
+        if (field.attributes.cached)
+            throw_parse_error(file, field.type_name.proto_name, "options `raw` and `cached` can't be combined");
+
+        return "spb::pb::raw<" + std::string(field.type_name.get_name()) + ">";
+    }
+
+    if (field.attributes.stream)
+        return "spb::stream_bytes";
+
+    if (field.attributes.cached)
+    {
+        if (field.type != proto_field::Type::MESSAGE)
+            throw_parse_error(file, field.type_name.proto_name, "option `cached` can be used only for messages");
+
+        return "spb::cached<" + std::string(field.type_name.get_name()) + ">";
+    }
+
     switch (field.type)
     {
     case proto_field::Type::NONE:
@@ -407,6 +435,20 @@ void dump_message_field(std::ostream &stream, const proto_field &field, const pr
     stream << ";\n";
 }
 
+void dump_message_unknown_fields(std::ostream &stream, const proto_message &message, const proto_file &file)
+{
+    if (!has_unknown_fields(file, message))
+        return;
+
+    for (const auto &field : message.fields)
+    {
+        if (field.name.get_name() == "unknown_fields")
+            throw_parse_error(file, field.name.proto_name, "field name `unknown_fields` is reserved");
+    }
+
+    stream << "std::vector<std::byte> unknown_fields;\n";
+}
+
 void dump_forwards(std::ostream &stream, const forwarded_declarations &forwards)
 {
     if (forwards.empty())
@@ -426,6 +468,10 @@ void get_std_includes(std::string_view ctype, std::string_view type, std_include
     result.string |= ctype.starts_with("std::string") || type.starts_with("std::string");
     result.optional |= ctype.starts_with("std::optional<") || type.starts_with("std::optional<");
     result.memory |= ctype.starts_with("std::unique_ptr<") || type.starts_with("std::unique_ptr<");
+    result.cached |= ctype.starts_with("spb::cached<");
+    result.stream_bytes |= ctype == "spb::stream_bytes";
+    result.string_view |= ctype.starts_with("std::string_view");
+    result.json_string |= ctype == "spb::json_string";
 }
 
 void get_std_includes(const proto_map &map, const proto_message &message, const proto_file &file,
@@ -461,6 +507,9 @@ void get_std_includes(const proto_oneof &oneof, const proto_file &file, std_incl
 
 void get_std_includes(const proto_message &message, const proto_file &file, std_includes &result)
 {
+    result.vector |= has_unknown_fields(file, message);
+    result.transcode |= has_transcoder(file, message);
+
     for (const auto &map : message.maps)
     {
         get_std_includes(map, message, file, result);
@@ -493,6 +542,86 @@ auto get_std_includes(const proto_file &file) -> std_includes
     return result;
 }
 
+auto find_message(const proto_messages &messages, std::string_view name) -> const proto_message *
+{
+    for (const auto &message : messages)
+    {
+        if (message.name.proto_name == name)
+            return &message;
+
+        if (const auto *p_message = find_message(message.messages, name); p_message)
+            return p_message;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief find the message of a field in the file or in its imports, only the last part of the type name
+ *        is compared
+ */
+auto find_message(const proto_file &file, const proto_field &field) -> const proto_message *
+{
+    auto name = field.type_name.proto_name;
+    if (const auto dot = name.rfind('.'); dot != std::string_view::npos)
+        name.remove_prefix(dot + 1);
+
+    if (const auto *p_message = find_message(file.package.messages, name); p_message)
+        return p_message;
+
+    for (const auto &import : file.imports)
+    {
+        if (const auto *p_message = find_message(import.package.messages, name); p_message)
+            return p_message;
+    }
+    return nullptr;
+}
+
+auto needs_contiguous_input(const proto_file &file, const proto_message &message,
+                            std::set<const proto_message *> &visited) -> bool;
+
+auto needs_contiguous_input(const proto_file &file, const proto_field &field, std::string_view ctype,
+                            std::set<const proto_message *> &visited) -> bool
+{
+    if (ctype.starts_with("std::string_view"))
+        return true;
+
+    //- raw sub-messages are kept encoded
+    if (field.type != proto_field::Type::MESSAGE || field.attributes.raw)
+        return false;
+
+    const auto *p_message = find_message(file, field);
+    return p_message != nullptr && needs_contiguous_input(file, *p_message, visited);
+}
+
+auto needs_contiguous_input(const proto_file &file, const proto_message &message,
+                            std::set<const proto_message *> &visited) -> bool
+{
+    //- recursive messages are checked only once
+    if (!visited.insert(&message).second)
+        return false;
+
+    for (const auto &field : message.fields)
+    {
+        if (needs_contiguous_input(file, field, convert_to_ctype(file, field, message), visited))
+            return true;
+    }
+    for (const auto &map : message.maps)
+    {
+        if (needs_contiguous_input(file, map.key, convert_to_ctype(file, map.key), visited) ||
+            needs_contiguous_input(file, map.value, convert_to_ctype(file, map.value), visited))
+            return true;
+    }
+    for (const auto &oneof : message.oneofs)
+    {
+        for (const auto &field : oneof.fields)
+        {
+            if (needs_contiguous_input(file, field, convert_to_ctype(file, field), visited))
+                return true;
+        }
+    }
+    return false;
+}
+
 void dump_message(std::ostream &stream, const proto_message &message, const proto_file &file)
 {
     dump_comment(stream, message.comment);
@@ -525,6 +654,8 @@ void dump_message(std::ostream &stream, const proto_message &message, const prot
         dump_message_oneof(stream, oneof, file);
     }
 
+    dump_message_unknown_fields(stream, message, file);
+
     //- TODO: is this used in any way?
     // stream << "auto operator == ( const " << message.name << " & ) const noexcept ->
     // bool = default;\n"; stream << "auto operator != ( const " << message.name << " &
@@ -570,6 +701,12 @@ void throw_parse_error(const proto_file &file, std::string_view at, std::string_
     stream.throw_parse_error(message);
 }
 
+auto needs_contiguous_input(const proto_file &file, const proto_message &message) -> bool
+{
+    auto visited = std::set<const proto_message *>();
+    return needs_contiguous_input(file, message, visited);
+}
+
 void get_std_includes(cpp_includes &includes, const proto_file &file)
 {
     includes.insert("<spb/json.hpp>");
@@ -591,10 +728,20 @@ void get_std_includes(cpp_includes &includes, const proto_file &file)
         includes.insert("<map>");
     if (std_includes.string)
         includes.insert("<string>");
+    if (std_includes.string_view)
+        includes.insert("<string_view>");
     if (std_includes.vector)
         includes.insert("<vector>");
     if (std_includes.variant)
         includes.insert("<variant>");
+    if (std_includes.cached)
+        includes.insert("<spb/cached.hpp>");
+    if (std_includes.stream_bytes)
+        includes.insert("<spb/stream_bytes.hpp>");
+    if (std_includes.json_string)
+        includes.insert("<spb/json_string.hpp>");
+    if (std_includes.transcode)
+        includes.insert("<spb/transcode.hpp>");
 }
 
 void dump_cpp_definitions(const proto_file &file, std::ostream &stream)
@@ -614,6 +761,17 @@ void dump_cpp_definitions(const proto_file &file, std::ostream &stream)
     dump_package_end(ostream, file);
 }
 
+auto member_type(std::string_view full_name, std::string_view member) -> std::string
+{
+    return "decltype(" + std::string(full_name) + "::" + std::string(member) + ")";
+}
+
+auto variant_type(const proto_oneof &oneof, size_t index, std::string_view full_name) -> std::string
+{
+    return "std::variant_alternative_t<" + std::to_string(index + 1) + ", " +
+           member_type(full_name, oneof.name.get_name()) + ">";
+}
+
 auto replace(std::string_view input, std::string_view what, std::string_view with) -> std::string
 {
     auto result = std::string(input);
@@ -21,6 +21,32 @@
  */
 void dump_cpp_definitions(const proto_file &file, std::ostream &stream);
 
+/**
+ * @brief true if the message has `std::string_view` fields (directly or in sub-messages), they point into
+ *        the deserialized input, so the message can't be deserialized from a reader or a chain of segments
+ *
+ * @param file parsed proto
+ * @param message checked message
+ */
+auto needs_contiguous_input(const proto_file &file, const proto_message &message) -> bool;
+
+/**
+ * @brief C++ type of a message member in the generated code, `decltype(Message::member)`
+ *
+ * @param full_name fully qualified C++ name of the message
+ * @param member name of the member
+ */
+auto member_type(std::string_view full_name, std::string_view member) -> std::string;
+
+/**
+ * @brief C++ type of a oneof field in the generated code, the alternative of the oneof's `std::variant`
+ *
+ * @param oneof parsed oneof
+ * @param index index of the field in the oneof
+ * @param full_name fully qualified C++ name of the message
+ */
+auto variant_type(const proto_oneof &oneof, size_t index, std::string_view full_name) -> std::string;
+
 /**
  * Replaces all occurrences of a substring in a given string with another substring.
  *
@@ -10,6 +10,7 @@
 
 #include "dumper.h"
 #include "../header.h"
+#include "ast/ast-types.h"
 #include "ast/proto-field.h"
 #include "ast/proto-file.h"
 #include "template-h.h"
@@ -22,6 +23,7 @@
 #include <spb/json/deserialize.hpp>
 #include <string>
 #include <string_view>
+#include <vector>
 
 using namespace std::literals;
 
@@ -31,9 +33,10 @@ using message_dumper = spb::detail::function_ref<void(std::ostream &, const prot
                                                       const proto_message &, std::string_view)>;
 using enum_dumper    = spb::detail::function_ref<void(std::ostream &, const proto_enum &, std::string_view)>;
 
-void dump_prototypes(std::ostream &stream, std::string_view type)
+void dump_prototypes(std::ostream &stream, std::string_view type, bool contiguous_input_only = false)
 {
-    stream << replace(file_json_header_prototypes, "$", type);
+    stream << replace(replace(file_json_header_prototypes, "$", type), "@",
+                      contiguous_input_only ? " = delete" : "");
 }
 
 auto json_name_from_options(const proto_attributes &attributes) -> std::string_view
@@ -69,6 +72,8 @@ auto convert_to_camelCase(std::string_view input) -> std::string
     return result;
 }
 
+} // namespace
+
 auto json_field_name(const proto_base &field) -> std::string
 {
     if (const auto result = json_name_from_options(field.attributes); !result.empty())
@@ -79,6 +84,9 @@ auto json_field_name(const proto_base &field) -> std::string
     return std::string(field.name.proto_name);
 }
 
+namespace
+{
+
 auto json_field_name_or_camelCase(const proto_base &field) -> std::string
 {
     if (const auto result = json_name_from_options(field.attributes); !result.empty())
@@ -87,10 +95,11 @@ auto json_field_name_or_camelCase(const proto_base &field) -> std::string
     return convert_to_camelCase(field.name.proto_name);
 }
 
-void dump_prototypes(std::ostream &stream, const proto_message &message, std::string_view parent)
+void dump_prototypes(std::ostream &stream, const proto_file &file, const proto_message &message,
+                     std::string_view parent)
 {
     const auto message_with_parent = std::string(parent) + "::" + std::string(message.name.get_name());
-    dump_prototypes(stream, message_with_parent);
+    dump_prototypes(stream, message_with_parent, needs_contiguous_input(file, message));
 }
 
 void dump_prototypes(std::ostream &stream, const proto_enum &my_enum, std::string_view parent)
@@ -107,11 +116,12 @@ void dump_prototypes(std::ostream &stream, const proto_enums &enums, std::string
     }
 }
 
-void dump_prototypes(std::ostream &stream, const proto_messages &messages, std::string_view parent)
+void dump_prototypes(std::ostream &stream, const proto_file &file, const proto_messages &messages,
+                     std::string_view parent)
 {
     for (const auto &message : messages)
     {
-        dump_prototypes(stream, message, parent);
+        dump_prototypes(stream, file, message, parent);
     }
 
     for (const auto &message : messages)
@@ -120,7 +130,7 @@ void dump_prototypes(std::ostream &stream, const proto_messages &messages, std::
             continue;
 
         const auto message_with_parent = std::string(parent) + "::" + std::string(message.name.get_name());
-        dump_prototypes(stream, message.messages, message_with_parent);
+        dump_prototypes(stream, file, message.messages, message_with_parent);
     }
 
     for (const auto &message : messages)
@@ -138,7 +148,7 @@ void dump_prototypes(std::ostream &stream, const proto_file &file)
     const auto package_name = file.package.name.get_name().empty()
                                   ? std::string()
                                   : "::" + std::string(file.package.name.get_name());
-    dump_prototypes(stream, file.package.messages, package_name);
+    dump_prototypes(stream, file, file.package.messages, package_name);
     dump_prototypes(stream, file.package.enums, package_name);
 }
 
@@ -147,6 +157,7 @@ void dump_cpp_includes(std::ostream &stream, std::string_view header_file_path)
     stream << "#include \"" << header_file_path << "\"\n"
            << "#include <spb/json/serialize.hpp>\n"
            << "#include <spb/json/deserialize.hpp>\n"
+           << "#include <spb/json/validate.hpp>\n"
            << "#include <system_error>\n"
            << "#include <type_traits>\n\n";
 }
@@ -213,9 +224,10 @@ void dump_cpp_serialize_field(std::ostream &stream, const proto_file &file, cons
     stream << "\tswitch(index)\n\t{\n";
     for (size_t i = 0; i < oneof.fields.size(); ++i)
     {
-        stream << "\t\tcase " << i + 1 << ":\n\t\t\treturn serialize<";
+        stream << "\t\tcase " << i + 1 << ":\n\t\t\treturn serialize_field<";
         dump_field_attributes(stream, file, message, oneof.fields[i]);
-        stream << ">(stream, std::get<" << i + 1 << ">(value." << oneof.name.get_name() << "), \""
+        stream << ">(stream, " << oneof.fields[i].number << ", std::get<" << i + 1 << ">(value."
+               << oneof.name.get_name() << "), \""
                << json_field_name(oneof.fields[i]) << "\"sv);\n";
     }
     stream << "\t}\n";
@@ -247,6 +259,47 @@ void dump_cpp_serialize_enum_gen(std::ostream &stream, const proto_enum &my_enum
     stream << "\t}\n}\n\n";
 }
 
+/**
+ * @brief hash of JSON keys (and enum names) for the generated switch, `key_hash` with the first seed which
+ *        makes it collision-free for all names (keys sharing a hash are still told apart by a compare)
+ */
+class key_hasher
+{
+    uint32_t seed = 0;
+
+public:
+    explicit key_hasher(const std::set<std::string_view> &names)
+    {
+        for (auto candidate = uint32_t(0); candidate < 256; ++candidate)
+        {
+            auto hashes = std::set<uint32_t>();
+            for (const auto &name : names)
+            {
+                if (!hashes.insert(spb::json::detail::key_hash(name, candidate)).second)
+                    break;
+            }
+            if (hashes.size() == names.size())
+            {
+                seed = candidate;
+                return;
+            }
+        }
+    }
+
+    [[nodiscard]] auto hash(std::string_view name) const -> uint32_t
+    {
+        return spb::json::detail::key_hash(name, seed);
+    }
+
+    /**
+     * @brief dump hash of `variable` or of a string literal
+     */
+    void dump(std::ostream &stream, std::string_view variable) const
+    {
+        stream << "detail::key_hash(" << variable << ", " << seed << ")";
+    }
+};
+
 void dump_cpp_deserialize_enum_gen(std::ostream &stream, const proto_enum &my_enum,
                                    std::string_view full_name)
 {
@@ -260,21 +313,29 @@ void dump_cpp_deserialize_enum_gen(std::ostream &stream, const proto_enum &my_en
     size_t key_size_min = UINT32_MAX;
     size_t key_size_max = 0;
 
-    auto name_map = std::multimap<uint32_t, std::string_view>();
+    auto names = std::set<std::string_view>();
     for (const auto &field : my_enum.fields)
     {
-        name_map.emplace(spb::json::detail::djb2_hash(field.name.get_name()), field.name.get_name());
+        names.insert(field.name.get_name());
         key_size_min = std::min(key_size_min, field.name.get_name().size());
         key_size_max = std::max(key_size_max, field.name.get_name().size());
     }
 
+    const auto hasher = key_hasher(names);
+    auto name_map     = std::multimap<uint32_t, std::string_view>();
+    for (const auto &field : my_enum.fields)
+    {
+        name_map.emplace(hasher.hash(field.name.get_name()), field.name.get_name());
+    }
+
     stream << "void deserialize_value_gen(auto &stream, " << full_name << " & value)\n{\n";
     stream << "\tchar buffer[" << key_size_max << "];\n";
     stream << "\tauto enum_value = deserialize_string_or_int(stream, " << key_size_min << ", " << key_size_max
            << ", buffer);\n";
     stream << "\tstd::visit(detail::overloaded{\n\t\t[&](std::string_view enum_str)\n\t\t{\n";
-    stream << "\t\t\tconst auto enum_hash = djb2_hash(enum_str);\n";
-    stream << "\t\t\tswitch (enum_hash)\n\t\t\t{\n";
+    stream << "\t\t\tswitch (";
+    hasher.dump(stream, "enum_str");
+    stream << ")\n\t\t\t{\n";
     auto last_hash = name_map.begin()->first + 1;
     auto put_break = false;
     for (const auto &[hash, name] : name_map)
@@ -286,7 +347,9 @@ void dump_cpp_deserialize_enum_gen(std::ostream &stream, const proto_enum &my_en
                 stream << "\t\t\t\tbreak;\n";
 
             put_break = true;
-            stream << "\t\t\tcase detail::djb2_hash(\"" << name << "\"sv):\n";
+            stream << "\t\t\tcase ";
+            hasher.dump(stream, "\"" + std::string(name) + "\"sv");
+            stream << ":\n";
         }
         stream << "\t\t\t\tif (enum_str == \"" << name << "\"sv)\n\t\t\t\t{\n\t\t\t\t\tvalue = " << full_name
                << "::" << name << ";\n\t\t\t\t\treturn ;\n\t\t\t\t}\n";
@@ -313,28 +376,33 @@ void dump_cpp_deserialize_enum_gen(std::ostream &stream, const proto_enum &my_en
 void dump_cpp_serialize_field(std::ostream &stream, const proto_file &file, const proto_message &message,
                               const proto_field &field)
 {
-    stream << "\tserialize<";
+    stream << "\tserialize_field<";
     dump_field_attributes(stream, file, message, field);
-    stream << ">(stream, value." << field.name.get_name() << ", \"" << json_field_name(field) << "\"sv);\n";
+    stream << ">(stream, " << field.number << ", value." << field.name.get_name() << ", \""
+           << json_field_name(field) << "\"sv);\n";
 }
 
 void dump_cpp_serialize_field(std::ostream &stream, const proto_file &file, const proto_message &message,
                               const proto_map &map)
 {
-    stream << "\tserialize<";
+    stream << "\tserialize_field<";
     dump_field_attributes(stream, file, message, map.key);
-    stream << ">(stream, value." << map.name.get_name() << ", \"" << json_field_name(map) << "\"sv);\n";
+    stream << ">(stream, " << map.number << ", value." << map.name.get_name() << ", \"" << json_field_name(map)
+           << "\"sv);\n";
 }
 
 void dump_cpp_serialize_enum(std::ostream &stream, const proto_enum &, std::string_view full_name)
 {
     stream << replace(json_serialize_value_template, "$", full_name);
+    stream << replace(json_deserialize_value_reader_template, "$", full_name);
 }
 
-void dump_cpp_serialize_message(std::ostream &stream, const proto_file &, const proto_message &,
+void dump_cpp_serialize_message(std::ostream &stream, const proto_file &file, const proto_message &message,
                                 std::string_view full_name)
 {
     stream << replace(json_serialize_value_template, "$", full_name);
+    if (!needs_contiguous_input(file, message))
+        stream << replace(json_deserialize_value_reader_template, "$", full_name);
 }
 
 void dump_cpp_serialize_message_gen(std::ostream &stream, const proto_file &file,
@@ -362,6 +430,36 @@ void dump_cpp_serialize_message_gen(std::ostream &stream, const proto_file &file
     stream << "}\n";
 }
 
+void dump_cpp_deserialize_key(std::ostream &stream, const json_key &key, const proto_file &file,
+                              const proto_message &message)
+{
+    if (key.p_oneof)
+    {
+        stream << "\t\t\t\treturn deserialize_variant<";
+        dump_field_attributes(stream, file, message, proto_attributes{});
+        stream << ", " << key.oneof_index + 1 << ">(stream, value." << key.p_oneof->name.get_name() << ");\n";
+    }
+    else if (key.p_map)
+    {
+        stream << "\t\t\t\treturn deserialize<";
+        dump_field_attributes(stream, file, message, proto_attributes{});
+        stream << ">(stream, value." << key.p_map->name.get_name() << ");\n";
+    }
+    else if (!key.p_field->bit_field.empty())
+    {
+        stream << "\t\t\t\tvalue." << key.p_field->name.get_name() << " = deserialize_bitfield<";
+        dump_field_attributes(stream, file, message, key.p_field->attributes);
+        stream << ", decltype(value." << key.p_field->name.get_name() << ")>(stream, "
+               << key.p_field->bit_field << ");\n\t\t\t\treturn ;\n";
+    }
+    else
+    {
+        stream << "\t\t\t\treturn deserialize<";
+        dump_field_attributes(stream, file, message, key.p_field->attributes);
+        stream << ">(stream, value." << key.p_field->name.get_name() << ");\n";
+    }
+}
+
 void dump_cpp_deserialize_message_gen(std::ostream &stream, const proto_file &file,
                                       const proto_message &message, std::string_view full_name)
 {
@@ -372,139 +470,90 @@ void dump_cpp_deserialize_message_gen(std::ostream &stream, const proto_file &fi
         return;
     }
 
-    //- json deserializer needs to accept both camelCase (parsed_name) and the original field name
-    struct one_field
-    {
-        std::string parsed_name;
-        cpp_ident name;
-        proto_attributes attributes;
-        size_t oneof_index = SIZE_MAX;
-        std::string_view bitfield;
-    };
-
-    size_t key_size_min = UINT32_MAX;
-    size_t key_size_max = 0;
+    stream << "void deserialize_value_gen(auto & stream, " << full_name << " & value)\n{\n";
+    dump_json_key_dispatch(stream, message, [&](std::ostream &stream, const json_key &key)
+                           { dump_cpp_deserialize_key(stream, key, file, message); });
+    stream << "}\n";
+}
 
-    auto name_map = std::multimap<uint32_t, one_field>();
-    for (const auto &field : message.fields)
+void dump_cpp_validate_key(std::ostream &stream, const json_key &key, const proto_file &file,
+                           const proto_message &message, std::string_view full_name,
+                           const std::map<const proto_field *, size_t> &required_bits)
+{
+    if (key.p_oneof)
     {
-        key_size_min = std::min(key_size_min, field.name.proto_name.size());
-        key_size_max = std::max(key_size_max, field.name.proto_name.size());
-
-        const auto field_name = json_field_name_or_camelCase(field);
-        name_map.emplace(spb::json::detail::djb2_hash(field_name), one_field{
-                                                                       .parsed_name = field_name,
-                                                                       .name        = field.name,
-                                                                       .attributes  = field.attributes,
-                                                                       .bitfield    = field.bit_field,
-                                                                   });
-        if (field_name != field.name.proto_name)
-        {
-            key_size_min = std::min(key_size_min, field_name.size());
-            key_size_max = std::max(key_size_max, field_name.size());
-
-            name_map.emplace(spb::json::detail::djb2_hash(field.name.proto_name),
-                             one_field{
-                                 .parsed_name = std::string(field.name.proto_name),
-                                 .name        = field.name,
-                                 .attributes  = field.attributes,
-                                 .bitfield    = field.bit_field,
-                             });
-        }
+        stream << "\t\t\t\treturn validate_variant<";
+        dump_field_attributes(stream, file, message, proto_attributes{});
+        stream << ", " << key.oneof_index + 1 << ", "
+               << member_type(full_name, key.p_oneof->name.get_name()) << ">(stream);\n";
     }
-    for (const auto &field : message.maps)
+    else if (key.p_map)
     {
-        key_size_min = std::min(key_size_min, field.name.proto_name.size());
-        key_size_max = std::max(key_size_max, field.name.proto_name.size());
+        stream << "\t\t\t\treturn validate<";
+        dump_field_attributes(stream, file, message, proto_attributes{});
+        stream << ", " << member_type(full_name, key.p_map->name.get_name()) << ">(stream);\n";
+    }
+    else
+    {
+        if (const auto it = required_bits.find(key.p_field); it != required_bits.end())
+            stream << "\t\t\t\tpresent |= uint64_t(1) << " << it->second << ";\n";
 
-        const auto field_name = json_field_name_or_camelCase(field);
-        name_map.emplace(spb::json::detail::djb2_hash(field_name), one_field{
-                                                                       .parsed_name = field_name,
-                                                                       .name        = field.name,
-                                                                   });
-        if (field_name != field.name.proto_name)
+        const auto member = member_type(full_name, key.p_field->name.get_name());
+        if (!key.p_field->bit_field.empty())
         {
-            key_size_min = std::min(key_size_min, field_name.size());
-            key_size_max = std::max(key_size_max, field_name.size());
-
-            name_map.emplace(
-                spb::json::detail::djb2_hash(field.name.proto_name),
-                one_field{.parsed_name = std::string(field.name.proto_name), .name = field.name});
+            stream << "\t\t\t\treturn validate_bitfield<";
+            dump_field_attributes(stream, file, message, key.p_field->attributes);
+            stream << ", " << member << ">(stream, " << key.p_field->bit_field << ");\n";
         }
-    }
-    for (const auto &oneof : message.oneofs)
-    {
-        for (size_t i = 0; i < oneof.fields.size(); ++i)
+        else
         {
-            key_size_min = std::min(key_size_min, oneof.fields[i].name.proto_name.size());
-            key_size_max = std::max(key_size_max, oneof.fields[i].name.proto_name.size());
-
-            const auto field_name = json_field_name_or_camelCase(oneof.fields[i]);
-            name_map.emplace(spb::json::detail::djb2_hash(field_name), one_field{
-                                                                           .parsed_name = field_name,
-                                                                           .name        = oneof.name,
-                                                                           .oneof_index = i,
-                                                                       });
-            if (field_name != oneof.fields[i].name.proto_name)
-            {
-                key_size_min = std::min(key_size_min, field_name.size());
-                key_size_max = std::max(key_size_max, field_name.size());
-
-                name_map.emplace(spb::json::detail::djb2_hash(oneof.fields[i].name.proto_name),
-                                 one_field{
-                                     .parsed_name = std::string(oneof.fields[i].name.proto_name),
-                                     .name        = oneof.name,
-                                     .oneof_index = i,
-                                 });
-            }
+            stream << "\t\t\t\treturn validate<";
+            dump_field_attributes(stream, file, message, key.p_field->attributes);
+            stream << ", " << member << ">(stream);\n";
         }
     }
+}
 
-    stream << "void deserialize_value_gen(auto & stream, " << full_name << " & value)\n{\n";
-    stream << "\tchar buffer[" << key_size_max << "];\n";
-    stream << "\tauto key = deserialize_key(stream, " << key_size_min << ", " << key_size_max
-           << ", buffer);\n";
-    stream << "\tswitch (djb2_hash(key))\n\t{\n";
-
-    auto last_hash = name_map.begin()->first + 1;
-    auto put_break = false;
-    for (const auto &[hash, field] : name_map)
+void dump_cpp_validate_message(std::ostream &stream, const proto_file &file, const proto_message &message,
+                               std::string_view full_name)
+{
+    stream << "void validate_value(istream_buffer &stream, std::type_identity<" << full_name << ">)\n{\n";
+    if (message.fields.empty() && message.maps.empty() && message.oneofs.empty())
     {
-        if (hash != last_hash)
-        {
-            if (put_break)
-                stream << "\t\t\tbreak;\n";
+        stream << "\tvalidate_object(stream, [](istream_buffer &stream) "
+                  "{ ignore_key_and_value(stream); });\n}\n\n";
+        return;
+    }
 
-            put_break = true;
-            last_hash = hash;
-            stream << "\t\tcase detail::djb2_hash(\"" << field.parsed_name << "\"sv):\n";
-        }
-        stream << "\t\t\tif (key == \"" << field.parsed_name << "\"sv)\n\t\t\t{\n";
-        if (field.oneof_index == SIZE_MAX)
-        {
-            if (!field.bitfield.empty())
-            {
-                stream << "\t\t\t\tvalue." << field.name.get_name() << " = deserialize_bitfield<";
-                dump_field_attributes(stream, file, message, field.attributes);
-                stream << ", decltype(value." << field.name.get_name() << ")>(stream, " << field.bitfield
-                       << ");\n\t\t\t\treturn ;\n";
-            }
-            else
-            {
-                stream << "\t\t\t\treturn deserialize<";
-                dump_field_attributes(stream, file, message, field.attributes);
-                stream << ">(stream, value." << field.name.get_name() << ");\n";
-            }
-        }
-        else
+    //- only the first 64 required fields are tracked
+    auto required_bits = std::map<const proto_field *, size_t>();
+    auto required_mask = uint64_t(0);
+    for (const auto &field : message.fields)
+    {
+        if (is_required(field) && required_bits.size() < 64)
         {
-            stream << "\t\t\t\treturn deserialize_variant<";
-            dump_field_attributes(stream, file, message, field.attributes);
-            stream << ", " << field.oneof_index + 1 << ">(stream, value." << field.name.get_name() << ");\n";
+            required_mask |= uint64_t(1) << required_bits.size();
+            required_bits.emplace(&field, required_bits.size());
         }
-        stream << "\t\t\t}\n";
     }
-    stream << "\t\t\tbreak;\n\t}\n\treturn skip_value(stream);\n}\n";
+
+    if (required_mask)
+        stream << "\tauto present = uint64_t(0);\n";
+    stream << "\tvalidate_object(stream, [&](istream_buffer &stream)\n\t{\n";
+    //- values of unknown keys are fully checked, not just skipped
+    dump_json_key_dispatch(
+        stream, message, [&](std::ostream &stream, const json_key &key)
+        { dump_cpp_validate_key(stream, key, file, message, full_name, required_bits); }, "ignore_value");
+    stream << "\t});\n";
+    if (required_mask)
+        stream << "\tcheck_required(present, " << required_mask << "U);\n";
+    stream << "}\n\n";
+}
+
+void dump_cpp_validate_enum(std::ostream &stream, const proto_enum &, std::string_view full_name)
+{
+    stream << "void validate_value(istream_buffer &stream, std::type_identity<" << full_name << ">)\n{\n"
+           << "\tauto value = " << full_name << "();\n\tdeserialize_value(stream, value);\n}\n\n";
 }
 
 void dump_cpp_enum(std::ostream &stream, const proto_enum &my_enum, std::string_view parent,
@@ -557,6 +606,115 @@ void dump_cpp(std::ostream &stream, const proto_file &file, message_dumper dump_
 
 } // namespace
 
+void dump_json_field_attributes(std::ostream &stream, const proto_file &file, const proto_message &message,
+                                const proto_attributes &attributes)
+{
+    dump_field_attributes(stream, file, message, attributes);
+}
+
+void dump_json_key_dispatch(std::ostream &stream, const proto_message &message, json_key_dumper dump_case,
+                            std::string_view skip_unknown)
+{
+    //- json deserializer needs to accept both camelCase (parsed_name) and the original field name
+    size_t key_size_min = UINT32_MAX;
+    size_t key_size_max = 0;
+
+    //- one entry per field in the order `serialize_value_gen` writes them, the index is the field's key id
+    auto fields   = std::vector<json_key>();
+    auto expected = std::vector<std::string>();
+    auto keys     = std::vector<std::pair<std::string, size_t>>();
+    auto add_key  = [&](const proto_base &field, json_key key)
+    {
+        const auto field_name = json_field_name_or_camelCase(field);
+        key_size_min          = std::min(key_size_min, field_name.size());
+        key_size_max          = std::max(key_size_max, field_name.size());
+        key.parsed_name       = field_name;
+        keys.emplace_back(field_name, fields.size());
+        if (field_name != field.name.proto_name)
+        {
+            key_size_min = std::min(key_size_min, field.name.proto_name.size());
+            key_size_max = std::max(key_size_max, field.name.proto_name.size());
+            keys.emplace_back(field.name.proto_name, fields.size());
+        }
+        expected.push_back(json_field_name(field));
+        fields.push_back(key);
+    };
+
+    for (const auto &field : message.fields)
+    {
+        add_key(field, json_key{.p_field = &field});
+    }
+    for (const auto &map : message.maps)
+    {
+        add_key(map, json_key{.p_map = &map});
+    }
+    for (const auto &oneof : message.oneofs)
+    {
+        for (size_t i = 0; i < oneof.fields.size(); ++i)
+        {
+            add_key(oneof.fields[i], json_key{.p_field = &oneof.fields[i], .p_oneof = &oneof, .oneof_index = i});
+        }
+    }
+
+    auto names = std::set<std::string_view>();
+    for (const auto &[name, id] : keys)
+    {
+        names.insert(name);
+    }
+
+    const auto hasher = key_hasher(names);
+    auto name_map     = std::multimap<uint32_t, const std::pair<std::string, size_t> *>();
+    for (const auto &key : keys)
+    {
+        name_map.emplace(hasher.hash(key.first), &key);
+    }
+
+    //- keys are predicted in the serialization order first, the hashed lookup is used on a miss
+    stream << "\tstatic constexpr auto keys = std::array{";
+    for (const auto &name : expected)
+    {
+        stream << (&name == &expected.front() ? "" : ", ") << "\"\\\"" << name << "\\\":\"sv";
+    }
+    stream << "};\n";
+    stream << "\tauto key_id = consume_expected_key(stream, keys);\n";
+    stream << "\tif (key_id == keys.size())\n\t{\n";
+    stream << "\t\tchar buffer[" << key_size_max << "];\n";
+    stream << "\t\tconst auto key = deserialize_key(stream, " << key_size_min << ", " << key_size_max
+           << ", buffer);\n";
+    stream << "\t\tswitch (";
+    hasher.dump(stream, "key");
+    stream << ")\n\t\t{\n";
+
+    auto last_hash = name_map.begin()->first + 1;
+    auto put_break = false;
+    for (const auto &[hash, p_key] : name_map)
+    {
+        if (hash != last_hash)
+        {
+            if (put_break)
+                stream << "\t\t\tbreak;\n";
+
+            put_break = true;
+            last_hash = hash;
+            stream << "\t\tcase ";
+            hasher.dump(stream, "\"" + p_key->first + "\"sv");
+            stream << ":\n";
+        }
+        stream << "\t\t\tif (key == \"" << p_key->first << "\"sv)\n\t\t\t\tkey_id = " << p_key->second
+               << ";\n";
+    }
+    stream << "\t\t\tbreak;\n\t\t}\n\t\tstream.next_key = key_id + 1;\n\t}\n";
+
+    stream << "\tswitch (key_id)\n\t{\n";
+    for (size_t id = 0; id < fields.size(); ++id)
+    {
+        stream << "\t\tcase " << id << ":\n\t\t\t{\n";
+        dump_case(stream, fields[id]);
+        stream << "\t\t\t}\n";
+    }
+    stream << "\t}\n\treturn " << skip_unknown << "(stream);\n";
+}
+
 void dump_json_header(const proto_file &file, std::ostream &stream)
 {
     dump_cpp_open_namespace(stream, "spb::json");
@@ -574,5 +732,6 @@ void dump_json_cpp(const proto_file &file, const std::filesystem::path &header_f
     dump_cpp(stream, file, dump_cpp_serialize_message_gen, dump_cpp_serialize_enum_gen);
     dump_cpp(stream, file, dump_cpp_deserialize_message_gen, dump_cpp_deserialize_enum_gen);
     dump_cpp(stream, file, dump_cpp_serialize_message, dump_cpp_serialize_enum);
+    dump_cpp(stream, file, dump_cpp_validate_message, dump_cpp_validate_enum);
     dump_cpp_close_namespace(stream, "spb::json::detail");
 }
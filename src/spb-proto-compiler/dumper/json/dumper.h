@@ -11,7 +11,12 @@
 #pragma once
 
 #include "ast/proto-file.h"
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <spb/io/function_ref.hpp>
+#include <string>
+#include <string_view>
 
 /**
  * @brief dump C++ header file for parsed proto
@@ -30,3 +35,47 @@ void dump_json_header(const proto_file &file, std::ostream &stream);
  * @param stream output stream
  */
 void dump_json_cpp(const proto_file &file, const std::filesystem::path &header_file, std::ostream &stream);
+
+/**
+ * @brief JSON name of a field, `json_name` option or the field's name
+ */
+[[nodiscard]] auto json_field_name(const proto_base &field) -> std::string;
+
+/**
+ * @brief dump `field_attributes{...}` (used also by other dumpers)
+ *
+ * @param stream output stream
+ * @param file parsed proto
+ * @param message parent of the field
+ * @param attributes field's attributes
+ */
+void dump_json_field_attributes(std::ostream &stream, const proto_file &file, const proto_message &message,
+                                const proto_attributes &attributes);
+
+/**
+ * @brief JSON key of a field, every field has a key for `json_name` (or camelCase) and for the original name
+ */
+struct json_key
+{
+    std::string parsed_name;
+    //- field or oneof field, nullptr for a map
+    const proto_field *p_field = nullptr;
+    const proto_map *p_map     = nullptr;
+    //- oneof containing the field
+    const proto_oneof *p_oneof = nullptr;
+    size_t oneof_index         = SIZE_MAX;
+};
+
+using json_key_dumper = spb::detail::function_ref<void(std::ostream &, const json_key &)>;
+
+/**
+ * @brief dump reading of a JSON key from `stream` and a switch over all keys of the message (used also by
+ *        other dumpers), unknown keys have their value skipped
+ *
+ * @param stream output stream
+ * @param message message with at least one field
+ * @param dump_case dumps the code for a matched key
+ * @param skip_unknown function called for the value of an unknown key
+ */
+void dump_json_key_dispatch(std::ostream &stream, const proto_message &message, json_key_dumper dump_case,
+                            std::string_view skip_unknown = "skip_value");
@@ -25,9 +25,9 @@ void serialize_value(ostream_buffer &stream, const $ &message)
 {
     return serialize_value_gen(stream, message);
 }
-void deserialize_value(istream_reader &stream, $ &message)
+void serialize_value(ostream_growable &stream, const $ &message)
 {
-    return deserialize_value_gen(stream, message);
+    return serialize_value_gen(stream, message);
 }
 void deserialize_value(istream_buffer &stream, $ &message)
 {
@@ -35,12 +35,23 @@ void deserialize_value(istream_buffer &stream, $ &message)
 }
 )";
 
+//- not generated for messages with `std::string_view` fields, their prototypes are deleted
+constexpr std::string_view json_deserialize_value_reader_template =
+    R"(void deserialize_value(istream_reader &stream, $ &message)
+{
+    return deserialize_value_gen(stream, message);
+}
+)";
+
+//- `@` is ` = delete` for messages with `std::string_view` fields
 constexpr std::string_view file_json_header_prototypes =
     R"(void serialize_value(ostream_size &, const $ &message);
 void serialize_value(ostream_writer &, const $ &message);
 void serialize_value(ostream_buffer &, const $ &message);
-void deserialize_value(istream_reader &, $ &message);
+void serialize_value(ostream_growable &, const $ &message);
+void deserialize_value(istream_reader &, $ &message)@;
 void deserialize_value(istream_buffer &, $ &message);
+void validate_value(istream_buffer &, std::type_identity<$>);
 )";
 
 constexpr std::string_view file_json_header_template =
@@ -53,7 +64,7 @@ constexpr std::string_view file_json_header_template =
  * @return serialized size in bytes
  * @throws exceptions only from `on_write`
  */
-size_t serialize(const auto &message, spb::io::writer on_write);
+size_t serialize(const auto &message, spb::io::writer on_write, const serialize_options &options);
 
 /**
  * @brief return JSON serialized size in bytes
@@ -62,9 +73,9 @@ size_t serialize(const auto &message, spb::io::writer on_write);
  * @param[in] options
  * @return serialized size in bytes
  */
-[[nodiscard]] size_t serialize_size(const auto &message);
+[[nodiscard]] size_t serialize_size(const auto &message, const serialize_options &options);
 
-size_t serialize(const auto &message, void *buffer);
+size_t serialize(const auto &message, void *buffer, const serialize_options &options);
 
 /**
  * @brief serialize message into JSON
@@ -77,7 +88,8 @@ size_t serialize(const auto &message, void *buffer);
  * @example `std::string json;`
  *          `spb::json::serialize(message, json);`
  */
-template <spb::resizable_container Container> size_t serialize(const auto &message, Container &result);
+template <spb::resizable_container Container>
+size_t serialize(const auto &message, Container &result, const serialize_options &options);
 
 /**
  * @brief serialize message into JSON
@@ -89,9 +101,9 @@ template <spb::resizable_container Container> size_t serialize(const auto &messa
  * @example `auto serialized_message = spb::json::serialize< std::vector< std::byte > >( message );`
  */
 template <spb::resizable_container Container>
-[[nodiscard]] Container serialize(const auto &message);
+[[nodiscard]] Container serialize(const auto &message, const serialize_options &options);
 
-size_t deserialize(auto &message, const void *buffer, size_t size);
+size_t deserialize(auto &message, const void *buffer, size_t size, const deserialize_options &options);
 
 /**
  * @brief deserialize message from JSON
@@ -101,7 +113,16 @@ size_t deserialize(auto &message, const void *buffer, size_t size);
  * @param[out] message deserialized message
  * @throws std::runtime_error on error
  */
-size_t deserialize(auto &message, spb::io::reader reader);
+size_t deserialize(auto &message, spb::io::reader reader, const deserialize_options &options);
+
+/**
+ * @brief deserialize message from JSON lent in chunks by the reader, the chunks are parsed in place
+ *
+ * @param[in] reader function lending the chunks
+ * @param[out] message deserialized message
+ * @throws std::runtime_error on error
+ */
+size_t deserialize(auto &message, spb::io::chunk_reader reader);
 
 /**
  * @brief deserialize message from JSON
@@ -114,7 +135,7 @@ size_t deserialize(auto &message, spb::io::reader reader);
  *          `auto message = Message();`
  *          `spb::json::deserialize(message, serialized);`
  */
-size_t deserialize(auto &message, const spb::size_container auto &json);
+size_t deserialize(auto &message, const spb::size_container auto &json, const deserialize_options &options);
 
 /**
  * @brief deserialize message from JSON
@@ -127,7 +148,7 @@ size_t deserialize(auto &message, const spb::size_container auto &json);
  *          `auto message = spb::json::deserialize<Message>(serialized);`
  */
 template <typename Message>
-[[nodiscard]] Message deserialize(const spb::size_container auto &json);
+[[nodiscard]] Message deserialize(const spb::size_container auto &json, const deserialize_options &options);
 
 /**
  * @brief deserialize message from reader
@@ -137,5 +158,15 @@ template <typename Message>
  * @return deserialized message
  * @throws std::runtime_error on error
  */
-template <typename Message> [[nodiscard]] Message deserialize(spb::io::reader reader);
+template <typename Message>
+[[nodiscard]] Message deserialize(spb::io::reader reader, const deserialize_options &options);
+
+/**
+ * @brief deserialize message from JSON lent in chunks by the reader, the chunks are parsed in place
+ *
+ * @param[in] reader function lending the chunks
+ * @return deserialized message
+ * @throws std::runtime_error on error
+ */
+template <typename Message> [[nodiscard]] Message deserialize(spb::io::chunk_reader reader);
 )";
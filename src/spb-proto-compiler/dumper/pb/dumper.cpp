@@ -14,6 +14,8 @@
 #include "ast/proto-field.h"
 #include "ast/proto-file.h"
 #include "template-h.h"
+#include <cstdint>
+#include <set>
 #include <spb/io/function_ref.hpp>
 #include <string>
 #include <string_view>
@@ -25,22 +27,38 @@ namespace
 using func_dumper = spb::detail::function_ref<void(std::ostream &, const proto_file &, const proto_message &,
                                                    std::string_view)>;
 
-void dump_prototypes(std::ostream &stream, std::string_view type)
+using enum_dumper =
+    spb::detail::function_ref<void(std::ostream &, const proto_file &, const proto_enum &, std::string_view)>;
+
+void dump_prototypes(std::ostream &stream, const proto_file &file, const proto_message &message,
+                     std::string_view parent)
 {
-    stream << replace(file_pb_header_prototypes, "$", type);
+    const auto message_with_parent = std::string(parent) + "::" + std::string(message.name.get_name());
+    const auto deleted = needs_contiguous_input(file, message) ? " = delete" : "";
+    stream << replace(replace(file_pb_header_prototypes, "$", message_with_parent), "@", deleted);
+    if (has_iov(file, message))
+        stream << replace(file_pb_header_iov_prototypes, "$", message_with_parent);
+    if (has_trusted(file, message))
+        stream << replace(file_pb_header_trusted_prototypes, "$", message_with_parent);
+    if (has_chain(file, message))
+        stream << replace(replace(file_pb_header_chain_prototypes, "$", message_with_parent), "@", deleted);
 }
 
-void dump_prototypes(std::ostream &stream, const proto_message &message, std::string_view parent)
+void dump_enum_prototypes(std::ostream &stream, const proto_enums &enums, std::string_view parent)
 {
-    const auto message_with_parent = std::string(parent) + "::" + std::string(message.name.get_name());
-    dump_prototypes(stream, message_with_parent);
+    for (const auto &my_enum : enums)
+    {
+        const auto enum_with_parent = std::string(parent) + "::" + std::string(my_enum.name.get_name());
+        stream << replace(file_pb_header_enum_prototypes, "$", enum_with_parent);
+    }
 }
 
-void dump_prototypes(std::ostream &stream, const proto_messages &messages, std::string_view parent)
+void dump_prototypes(std::ostream &stream, const proto_file &file, const proto_messages &messages,
+                     std::string_view parent)
 {
     for (const auto &message : messages)
     {
-        dump_prototypes(stream, message, parent);
+        dump_prototypes(stream, file, message, parent);
     }
 
     for (const auto &message : messages)
@@ -49,7 +67,16 @@ void dump_prototypes(std::ostream &stream, const proto_messages &messages, std::
             continue;
 
         const auto message_with_parent = std::string(parent) + "::" + std::string(message.name.get_name());
-        dump_prototypes(stream, message.messages, message_with_parent);
+        dump_prototypes(stream, file, message.messages, message_with_parent);
+    }
+
+    for (const auto &message : messages)
+    {
+        if (message.enums.empty())
+            continue;
+
+        const auto message_with_parent = std::string(parent) + "::" + std::string(message.name.get_name());
+        dump_enum_prototypes(stream, message.enums, message_with_parent);
     }
 }
 
@@ -58,7 +85,8 @@ void dump_prototypes(std::ostream &stream, const proto_file &file)
     const auto package_name = file.package.name.get_name().empty()
                                   ? std::string()
                                   : "::" + std::string(file.package.name.get_name());
-    dump_prototypes(stream, file.package.messages, package_name);
+    dump_prototypes(stream, file, file.package.messages, package_name);
+    dump_enum_prototypes(stream, file.package.enums, package_name);
 }
 
 void dump_cpp_includes(std::ostream &stream, std::string_view header_file_path)
@@ -68,6 +96,8 @@ void dump_cpp_includes(std::ostream &stream, std::string_view header_file_path)
            << "#include <spb/pb.hpp>\n"
            << "#include <spb/pb/deserialize.hpp>\n"
            << "#include <spb/pb/serialize.hpp>\n"
+           << "#include <spb/pb/validate.hpp>\n"
+           << "#include <array>\n"
            << "#include <type_traits>\n\n";
 }
 
@@ -130,6 +160,8 @@ auto field_max_count(const proto_file &file, const proto_message &message, const
         message.attributes.max_count.value_or(file.attributes.max_count.value_or(0)));
 }
 
+} // namespace
+
 void dump_serialize_mode(std::ostream &stream, const proto_file &file, const proto_message &message,
                          const proto_field &field)
 {
@@ -189,10 +221,13 @@ void dump_serialize_mode(std::ostream &stream, const proto_file &file, const pro
     stream << "}";
 }
 
+namespace
+{
+
 void dump_cpp_serialize_field(std::ostream &stream, const proto_file &file, const proto_message &message,
                               const proto_field &field)
 {
-    stream << "\tserialize<";
+    stream << "\tserialize_field<";
     dump_serialize_mode(stream, file, message, field);
     stream << ">(stream, " << field.number << ", value." << field.name.get_name() << ");\n";
 }
@@ -200,7 +235,7 @@ void dump_cpp_serialize_field(std::ostream &stream, const proto_file &file, cons
 void dump_cpp_serialize_field(std::ostream &stream, const proto_file &file, const proto_message &message,
                               const proto_map &field)
 {
-    stream << "\tserialize<";
+    stream << "\tserialize_field<";
     dump_serialize_mode(stream, file, message, field);
     stream << ">(stream, " << field.number << ", value." << field.name.get_name() << ");\n";
 }
@@ -212,7 +247,7 @@ void dump_cpp_serialize_field(std::ostream &stream, const proto_file &file, cons
     stream << "\t\tswitch (index)\n\t\t{\n";
     for (size_t i = 0; i < oneof.fields.size(); ++i)
     {
-        stream << "\t\t\tcase " << i + 1 << ":\n\t\t\t\treturn serialize<";
+        stream << "\t\t\tcase " << i + 1 << ":\n\t\t\t\treturn serialize_field<";
         dump_serialize_mode(stream, file, message, oneof.fields[i]);
         stream << ">(stream, " << oneof.fields[i].number << ", std::get<" << i + 1 << ">(value."
                << oneof.name.get_name() << "));\n";
@@ -220,16 +255,28 @@ void dump_cpp_serialize_field(std::ostream &stream, const proto_file &file, cons
     stream << "\t\t}\n\t}\n\n";
 }
 
-void dump_cpp_serialize_value(std::ostream &stream, const proto_file &, const proto_message &,
+void dump_cpp_serialize_value(std::ostream &stream, const proto_file &file, const proto_message &message,
                               std::string_view full_name)
 {
     stream << replace(pb_serialize_value_template, "$", full_name);
+    if (has_iov(file, message))
+        stream << replace(pb_serialize_value_iov_template, "$", full_name);
+    if (has_trusted(file, message))
+        stream << replace(pb_deserialize_value_trusted_template, "$", full_name);
+    if (needs_contiguous_input(file, message))
+        return;
+
+    stream << replace(pb_deserialize_value_reader_template, "$", full_name);
+    if (has_chain(file, message))
+        stream << replace(pb_deserialize_value_chain_template, "$", full_name);
 }
 
 void dump_cpp_serialize_value_gen(std::ostream &stream, const proto_file &file, const proto_message &message,
                                   std::string_view full_name)
 {
-    if (message.fields.empty() && message.maps.empty() && message.oneofs.empty())
+    const auto unknown_fields = has_unknown_fields(file, message);
+
+    if (message.fields.empty() && message.maps.empty() && message.oneofs.empty() && !unknown_fields)
     {
         stream << "static void serialize_value_gen(auto &, const " << full_name << " &)\n{\n}\n\n";
         return;
@@ -249,14 +296,27 @@ void dump_cpp_serialize_value_gen(std::ostream &stream, const proto_file &file,
     {
         dump_cpp_serialize_field(stream, file, message, oneof);
     }
+    if (unknown_fields)
+    {
+        stream << "\tserialize_unknown(stream, value.unknown_fields);\n";
+    }
     stream << "}\n\n";
 }
 
 void dump_cpp_deserialize_value_gen(std::ostream &stream, const proto_file &file,
                                     const proto_message &message, std::string_view full_name)
 {
+    const auto unknown_fields = has_unknown_fields(file, message);
+
     if (message.fields.empty() && message.maps.empty() && message.oneofs.empty())
     {
+        if (unknown_fields)
+        {
+            stream << "static void deserialize_value_gen(auto &stream, " << full_name
+                   << " &value, tag_type tag)\n{\n";
+            stream << "\tdeserialize_unknown(stream, value.unknown_fields, tag);\n}\n\n";
+            return;
+        }
         stream << "static void deserialize_value_gen(auto &stream, " << full_name << " &, tag_type tag)\n{\n";
         stream << "\tskip(stream, wire_type_from_tag(tag));\n}\n\n";
         return;
@@ -303,7 +363,235 @@ void dump_cpp_deserialize_value_gen(std::ostream &stream, const proto_file &file
         }
     }
 
-    stream << "\t\tdefault:\n\t\t\treturn skip(stream, type);\t\n\t}\n}\n\n";
+    if (unknown_fields)
+        stream << "\t\tdefault:\n\t\t\treturn deserialize_unknown(stream, value.unknown_fields, tag);\t\n\t}\n}\n\n";
+    else
+        stream << "\t\tdefault:\n\t\t\treturn skip(stream, type);\t\n\t}\n}\n\n";
+}
+
+auto builder_value_type(const proto_field &field, std::string_view full_name) -> std::string
+{
+    const auto member = member_type(full_name, field.name.get_name());
+    switch (field.label)
+    {
+    case proto_field::Label::NONE:
+        return member;
+    case proto_field::Label::OPTIONAL:
+    case proto_field::Label::REPEATED:
+        return member + "::value_type";
+    case proto_field::Label::PTR:
+        return member + "::element_type";
+    }
+    return member;
+}
+
+void dump_cpp_validate_value(std::ostream &stream, const proto_file &file, const proto_message &message,
+                             std::string_view full_name)
+{
+    stream << "void validate_value(istream_buffer &stream, std::type_identity<" << full_name << ">)\n{\n";
+    if (message.fields.empty() && message.maps.empty() && message.oneofs.empty())
+    {
+        stream << "\tvalidate_message(stream, [](istream_buffer &stream, tag_type tag)\n\t{\n"
+               << "\t\tskip(stream, wire_type_from_tag(tag));\n\t});\n}\n\n";
+        return;
+    }
+
+    //- only the first 64 required fields are tracked
+    auto required_mask = uint64_t(0);
+    auto counters      = size_t(0);
+    auto required      = size_t(0);
+    for (const auto &field : message.fields)
+    {
+        if (is_required(field) && required < 64)
+            required_mask |= uint64_t(1) << required++;
+
+        if (field.label == proto_field::Label::REPEATED && field_max_count(file, message, field))
+            counters += 1;
+    }
+
+    if (required_mask)
+        stream << "\tauto present = uint64_t(0);\n";
+    if (counters)
+        stream << "\tsize_t counts[" << counters << "] = {};\n";
+
+    stream << "\tvalidate_message(stream, [&](istream_buffer &stream, tag_type tag)\n\t{\n"
+           << "\t\tconst auto type = wire_type_from_tag(tag);\n"
+           << "\t\tswitch(field_from_tag(tag))\n\t\t{\n";
+
+    auto counter = size_t(0);
+    required     = 0;
+    for (const auto &field : message.fields)
+    {
+        const auto member = member_type(full_name, field.name.get_name());
+        stream << "\t\t\tcase " << field.number << ":\n";
+        if (is_required(field) && required < 64)
+            stream << "\t\t\t\tpresent |= uint64_t(1) << " << required++ << ";\n";
+
+        if (!field.bit_field.empty())
+        {
+            stream << "\t\t\t\treturn validate_bitfield<";
+            dump_serialize_mode(stream, file, message, field);
+            stream << ", " << member << ">(stream, " << field.bit_field << ", type);\n";
+        }
+        else if (field.label == proto_field::Label::REPEATED && field_max_count(file, message, field))
+        {
+            stream << "\t\t\t\treturn validate_repeated<";
+            dump_serialize_mode(stream, file, message, field);
+            stream << ", " << member << ">(stream, type, counts[" << counter++ << "]);\n";
+        }
+        else
+        {
+            stream << "\t\t\t\treturn validate<";
+            dump_serialize_mode(stream, file, message, field);
+            stream << ", " << member << ">(stream, type);\n";
+        }
+    }
+    for (const auto &map : message.maps)
+    {
+        stream << "\t\t\tcase " << map.number << ":\n\t\t\t\treturn validate<";
+        dump_serialize_mode(stream, file, message, map);
+        stream << ", " << member_type(full_name, map.name.get_name()) << ">(stream, type);\n";
+    }
+    for (const auto &oneof : message.oneofs)
+    {
+        for (size_t i = 0; i < oneof.fields.size(); ++i)
+        {
+            stream << "\t\t\tcase " << oneof.fields[i].number << ":\n\t\t\t\treturn validate_variant<";
+            dump_serialize_mode(stream, file, message, oneof.fields[i]);
+            stream << ", " << i + 1 << ", " << member_type(full_name, oneof.name.get_name())
+                   << ">(stream, type);\n";
+        }
+    }
+    stream << "\t\t\tdefault:\n\t\t\t\treturn skip(stream, type);\n\t\t}\n\t});\n";
+    if (required_mask)
+        stream << "\tcheck_required(present, " << required_mask << "U);\n";
+    stream << "}\n\n";
+}
+
+void dump_cpp_validate_enum(std::ostream &stream, const proto_file &file, const proto_enum &my_enum,
+                            std::string_view full_name)
+{
+    stream << "void validate_value(istream_buffer &stream, std::type_identity<" << full_name << ">)\n{\n";
+
+    //- proto3 enums are open, unknown values are accepted (same as by deserialize)
+    if (file.syntax.version >= 3)
+    {
+        stream << "\t(void)read_varint<std::underlying_type_t<" << full_name << ">>(stream);\n}\n\n";
+        return;
+    }
+
+    stream << "\tswitch(" << full_name << "(read_varint<std::underlying_type_t<" << full_name
+           << ">>(stream)))\n\t{\n";
+
+    std::set<int32_t> numbers_taken;
+    for (const auto &field : my_enum.fields)
+    {
+        if (numbers_taken.insert(field.number).second)
+            stream << "\tcase " << full_name << "::" << field.name.get_name() << ":\n";
+    }
+    if (!numbers_taken.empty())
+        stream << "\t\treturn;\n";
+    stream << "\tdefault:\n\t\tthrow std::runtime_error(\"invalid enum value\");\n\t}\n}\n\n";
+}
+
+auto builder_method_name(const proto_field &field) -> std::string
+{
+    const auto prefix = field.label == proto_field::Label::REPEATED ? "add_"sv : "set_"sv;
+    return std::string(prefix) + std::string(field.name.get_name());
+}
+
+void dump_builder_begin(std::ostream &stream, const proto_field &field, std::string_view value_type)
+{
+    //- raw and cached fields are not messages, they can be written only by `set_` or `add_`
+    if (field.type != proto_field::Type::MESSAGE || field.attributes.raw || field.attributes.cached)
+        return;
+
+    stream << "template <typename Builder = builder<" << value_type << ">>\n"
+           << "[[nodiscard]] auto begin_" << field.name.get_name() << "() -> Builder\n{\n"
+           << "return Builder(*this, " << field.number << ");\n}\n"
+           << "template <typename Builder = builder<" << value_type << ">>\n"
+           << "[[nodiscard]] auto begin_" << field.name.get_name() << "(size_t size) -> Builder\n{\n"
+           << "return Builder(*this, " << field.number << ", size);\n}\n";
+}
+
+void dump_builder_declaration(std::ostream &stream, const proto_file &file, const proto_message &message,
+                              std::string_view full_name)
+{
+    if (!has_builder(file, message))
+        return;
+
+    stream << "template <> class builder<" << full_name << "> : public builder_base\n{\n"
+           << "public:\n"
+           << "using builder_base::builder_base;\n\n";
+
+    for (const auto &field : message.fields)
+    {
+        const auto value_type = builder_value_type(field, full_name);
+        stream << "void " << builder_method_name(field) << "(const " << value_type << " &value);\n";
+        dump_builder_begin(stream, field, value_type);
+    }
+    for (const auto &map : message.maps)
+    {
+        const auto member = member_type(full_name, map.name.get_name());
+        stream << "void add_" << map.name.get_name() << "(const " << member << "::key_type &key, const "
+               << member << "::mapped_type &value);\n";
+    }
+    for (const auto &oneof : message.oneofs)
+    {
+        for (size_t i = 0; i < oneof.fields.size(); ++i)
+        {
+            const auto value_type = variant_type(oneof, i, full_name);
+            stream << "void set_" << oneof.fields[i].name.get_name() << "(const " << value_type
+                   << " &value);\n";
+            dump_builder_begin(stream, oneof.fields[i], value_type);
+        }
+    }
+    stream << "};\n\n";
+}
+
+void dump_builder_definition(std::ostream &stream, const proto_file &file, const proto_message &message,
+                             const proto_field &field, std::string_view full_name,
+                             std::string_view value_type, std::string_view method_name)
+{
+    stream << "void builder<" << full_name << ">::" << method_name << "(const " << value_type
+           << " &value)\n{\n\tusing namespace detail;\n\n\tserialize<";
+    dump_serialize_mode(stream, file, message, field);
+    //- packed element is written as a packed record with one element, parsers concatenate them
+    if (encoder_type_str(file, field).starts_with("make_packed"))
+        stream << ">(stream, " << field.number << ", std::array{value});\n}\n\n";
+    else
+        stream << ">(stream, " << field.number << ", value);\n}\n\n";
+}
+
+void dump_builder_definitions(std::ostream &stream, const proto_file &file, const proto_message &message,
+                              std::string_view full_name)
+{
+    if (!has_builder(file, message))
+        return;
+
+    for (const auto &field : message.fields)
+    {
+        dump_builder_definition(stream, file, message, field, full_name, builder_value_type(field, full_name),
+                                builder_method_name(field));
+    }
+    for (const auto &map : message.maps)
+    {
+        const auto member = member_type(full_name, map.name.get_name());
+        stream << "void builder<" << full_name << ">::add_" << map.name.get_name() << "(const " << member
+               << "::key_type &key, const " << member << "::mapped_type &value)\n{\n"
+               << "\tusing namespace detail;\n\n\tserialize_map_entry<";
+        dump_serialize_mode(stream, file, message, map);
+        stream << ">(stream, " << map.number << ", key, value);\n}\n\n";
+    }
+    for (const auto &oneof : message.oneofs)
+    {
+        for (size_t i = 0; i < oneof.fields.size(); ++i)
+        {
+            dump_builder_definition(stream, file, message, oneof.fields[i], full_name,
+                                    variant_type(oneof, i, full_name),
+                                    "set_" + std::string(oneof.fields[i].name.get_name()));
+        }
+    }
 }
 
 void dump_cpp_messages(std::ostream &stream, const proto_file &file, const proto_messages &messages,
@@ -327,6 +615,35 @@ void dump_cpp_messages(std::ostream &stream, const proto_file &file, const proto
     }
 }
 
+void dump_cpp_enums(std::ostream &stream, const proto_file &file, const proto_enums &enums,
+                    std::string_view parent, enum_dumper dump_enum)
+{
+    for (const auto &my_enum : enums)
+    {
+        dump_enum(stream, file, my_enum, std::string(parent) + "::" + std::string(my_enum.name.get_name()));
+    }
+}
+
+void dump_cpp_enums(std::ostream &stream, const proto_file &file, const proto_messages &messages,
+                    std::string_view parent, enum_dumper dump_enum)
+{
+    for (const auto &message : messages)
+    {
+        const auto full_name = std::string(parent) + "::" + std::string(message.name.get_name());
+        dump_cpp_enums(stream, file, message.enums, full_name, dump_enum);
+        dump_cpp_enums(stream, file, message.messages, full_name, dump_enum);
+    }
+}
+
+void dump_cpp_enums(std::ostream &stream, const proto_file &file, enum_dumper dump_enum)
+{
+    const auto str_namespace = file.package.name.get_name().empty()
+                                   ? std::string()
+                                   : "::" + std::string(file.package.name.get_name());
+    dump_cpp_enums(stream, file, file.package.enums, str_namespace, dump_enum);
+    dump_cpp_enums(stream, file, file.package.messages, str_namespace, dump_enum);
+}
+
 void dump_cpp(std::ostream &stream, const proto_file &file, func_dumper dump_cpp)
 {
     const auto str_namespace = file.package.name.get_name().empty()
@@ -344,6 +661,7 @@ void dump_pb_header(const proto_file &file, std::ostream &stream)
     dump_cpp_open_namespace(stream, "detail");
     dump_prototypes(stream, file);
     dump_cpp_close_namespace(stream, "detail");
+    dump_cpp(stream, file, dump_builder_declaration);
     dump_cpp_close_namespace(stream, "spb::pb");
 }
 
@@ -354,5 +672,10 @@ void dump_pb_cpp(const proto_file &file, const std::filesystem::path &header_fil
     dump_cpp(stream, file, dump_cpp_serialize_value_gen);
     dump_cpp(stream, file, dump_cpp_deserialize_value_gen);
     dump_cpp(stream, file, dump_cpp_serialize_value);
+    dump_cpp_enums(stream, file, dump_cpp_validate_enum);
+    dump_cpp(stream, file, dump_cpp_validate_value);
     dump_cpp_close_namespace(stream, "spb::pb::detail");
+    dump_cpp_open_namespace(stream, "spb::pb");
+    dump_cpp(stream, file, dump_builder_definitions);
+    dump_cpp_close_namespace(stream, "spb::pb");
 }
@@ -30,3 +30,16 @@ void dump_pb_header(const proto_file &file, std::ostream &stream);
  * @param stream output stream
  */
 void dump_pb_cpp(const proto_file &file, const std::filesystem::path &header_file, std::ostream &stream);
+
+/**
+ * @brief dump `serialize_mode{...}` for a field (used also by other dumpers)
+ *
+ * @param stream output stream
+ * @param file parsed proto
+ * @param message parent of the field
+ * @param field field
+ */
+void dump_serialize_mode(std::ostream &stream, const proto_file &file, const proto_message &message,
+                         const proto_field &field);
+void dump_serialize_mode(std::ostream &stream, const proto_file &file, const proto_message &message,
+                         const proto_map &map);
@@ -25,22 +25,70 @@ void serialize_value(ostream_buffer &stream, const $ &message)
 {
     return serialize_value_gen(stream, message);
 }
-void deserialize_value(istream_reader &stream, $ &message, tag_type tag)
+void deserialize_value(istream_buffer &stream, $ &message, tag_type tag)
 {
     return deserialize_value_gen(stream, message, tag);
 }
-void deserialize_value(istream_buffer &stream, $ &message, tag_type tag)
+)";
+
+//- generated only with `(spb_msgopt).iov` (or `(spb_fileopt).iov`)
+constexpr std::string_view pb_serialize_value_iov_template =
+    R"(void serialize_value(ostream_iov &stream, const $ &message)
+{
+    return serialize_value_gen(stream, message);
+}
+)";
+
+//- generated only with `(spb_msgopt).trusted` (or `(spb_fileopt).trusted`), other messages read
+//- from `istream_trusted` bind to the checked `istream_buffer` overload
+constexpr std::string_view pb_deserialize_value_trusted_template =
+    R"(void deserialize_value(istream_trusted &stream, $ &message, tag_type tag)
 {
     return deserialize_value_gen(stream, message, tag);
 }
 )";
 
+//- not generated for messages with `std::string_view` fields, their prototypes are deleted
+constexpr std::string_view pb_deserialize_value_reader_template =
+    R"(void deserialize_value(istream_reader &stream, $ &message, tag_type tag)
+{
+    return deserialize_value_gen(stream, message, tag);
+}
+)";
+
+//- generated only with `(spb_msgopt).chain` (or `(spb_fileopt).chain`) and without `std::string_view` fields
+constexpr std::string_view pb_deserialize_value_chain_template =
+    R"(void deserialize_value(istream_chain &stream, $ &message, tag_type tag)
+{
+    return deserialize_value_gen(stream, message, tag);
+}
+)";
+
+//- `@` is ` = delete` for messages with `std::string_view` fields
 constexpr std::string_view file_pb_header_prototypes =
     R"(void serialize_value(ostream_size &, const $ &message);
 void serialize_value(ostream_writer &, const $ &message);
 void serialize_value(ostream_buffer &, const $ &message);
-void deserialize_value(istream_reader &, $ &message, tag_type);
+void deserialize_value(istream_reader &, $ &message, tag_type)@;
 void deserialize_value(istream_buffer &, $ &message, tag_type);
+void validate_value(istream_buffer &, std::type_identity<$>);
+)";
+
+constexpr std::string_view file_pb_header_iov_prototypes =
+    R"(void serialize_value(ostream_iov &, const $ &message);
+)";
+
+constexpr std::string_view file_pb_header_trusted_prototypes =
+    R"(void deserialize_value(istream_trusted &, $ &message, tag_type);
+)";
+
+//- `@` is ` = delete` for messages with `std::string_view` fields
+constexpr std::string_view file_pb_header_chain_prototypes =
+    R"(void deserialize_value(istream_chain &, $ &message, tag_type)@;
+)";
+
+constexpr std::string_view file_pb_header_enum_prototypes =
+    R"(void validate_value(istream_buffer &, std::type_identity<$>);
 )";
 
 constexpr std::string_view file_pb_header_template = R"(
@@ -74,6 +122,17 @@ auto serialize_size(const auto &message, const serialize_options &options) -> si
  */
 auto serialize(const auto &message, void *buffer, const serialize_options &options) -> size_t;
 
+/**
+ * @brief serialize message as a list of chunks (scatter-gather), large `bytes` and `string`
+ *        fields are referenced in place instead of being copied
+ *
+ * @param[in] message to be serialized
+ * @param[out] builder chunks of the serialized message
+ * @param[in] options
+ * @return serialized size in bytes
+ */
+auto serialize_iov(const auto &message, iovec_builder &builder, const serialize_options &options) -> size_t;
+
 /**
  * @brief serialize message into protobuf
  *
@@ -137,6 +196,18 @@ auto deserialize(Message &message, const Container &protobuf, const deserialize_
 template <typename Message, spb::size_container Container>
 auto deserialize(const Container &protobuf, const deserialize_options &options) -> Message;
 
+/**
+ * @brief deserialize message from a chain of (non-contiguous) segments, without concatenating them
+ *
+ * @param[in] segments message split into segments (like a network buffer chain)
+ * @param[in] options
+ * @param[out] message deserialized message
+ * @return consumed size in bytes
+ * @throws std::runtime_error on error
+ */
+auto deserialize(auto &message, std::span<const std::span<const std::byte>> segments,
+                 const deserialize_options &options) -> size_t;
+
 /**
  * @brief deserialize message from reader
  *
@@ -0,0 +1,201 @@
+/***************************************************************************\
+* Name        : transcode dumper                                            *
+* Description : generate C++ src files for protobuf <-> JSON transcoding    *
+* Author      : antonin.kriz@gmail.com                                      *
+* ------------------------------------------------------------------------- *
+* This is free software; you can redistribute it and/or modify it under the *
+* terms of the MIT license. A copy of the license can be found in the file  *
+* "LICENSE" at the root of this distribution.                               *
+\***************************************************************************/
+
+#include "dumper.h"
+#include "../header.h"
+#include "../json/dumper.h"
+#include "../pb/dumper.h"
+#include "ast/ast-types.h"
+#include "ast/proto-field.h"
+#include "ast/proto-file.h"
+#include <spb/io/function_ref.hpp>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+namespace
+{
+using func_dumper = spb::detail::function_ref<void(std::ostream &, const proto_file &, const proto_message &,
+                                                   std::string_view)>;
+
+auto has_transcoder(const proto_file &file, const proto_messages &messages) -> bool
+{
+    for (const auto &message : messages)
+    {
+        if (has_transcoder(file, message) || has_transcoder(file, message.messages))
+            return true;
+    }
+    return false;
+}
+
+void dump_transcoder_declaration(std::ostream &stream, const proto_file &file, const proto_message &message,
+                                 std::string_view full_name)
+{
+    if (!has_transcoder(file, message))
+        return;
+
+    stream << "template <> struct transcoder<" << full_name << ">\n{\n"
+           << "static auto pb_to_json_field(detail::pb_istream &in, detail::json_ostream &out, "
+              "spb::pb::detail::tag_type tag, detail::pb_to_json_state &state) -> bool;\n"
+           << "static void json_to_pb_field(detail::json_istream &stream, detail::pb_ostream &out);\n"
+           << "};\n\n";
+}
+
+void dump_pb_to_json_case(std::ostream &stream, const proto_file &file, const proto_message &message,
+                          const auto &field, std::string_view type)
+{
+    stream << "\tcase " << field.number << ":\n\t\tdetail::pb_to_json_field<";
+    dump_serialize_mode(stream, file, message, field);
+    stream << ", " << type << ">(in, out, tag, \"" << json_field_name(field) << "\"sv, state);\n"
+           << "\t\treturn true;\n";
+}
+
+void dump_json_to_pb_case(std::ostream &stream, const proto_file &file, const proto_message &message,
+                          const json_key &key, std::string_view full_name)
+{
+    const auto &field = key.p_map ? static_cast<const proto_base &>(*key.p_map) : *key.p_field;
+
+    if (key.p_field && !key.p_field->bit_field.empty())
+        stream << "\t\t\t\treturn detail::json_to_pb_bitfield<";
+    else
+        stream << "\t\t\t\treturn detail::json_to_pb_field<";
+
+    if (key.p_map)
+    {
+        dump_serialize_mode(stream, file, message, *key.p_map);
+        stream << ", ";
+        dump_json_field_attributes(stream, file, message, proto_attributes{});
+    }
+    else
+    {
+        dump_serialize_mode(stream, file, message, *key.p_field);
+        stream << ", ";
+        dump_json_field_attributes(stream, file, message, key.p_field->attributes);
+    }
+
+    stream << ", "
+           << (key.p_oneof ? variant_type(*key.p_oneof, key.oneof_index, full_name)
+                           : member_type(full_name, field.name.get_name()))
+           << ">(stream, out, " << field.number;
+    if (key.p_field && !key.p_field->bit_field.empty())
+        stream << ", " << key.p_field->bit_field;
+    stream << ");\n";
+}
+
+void dump_json_to_pb_definition(std::ostream &stream, const proto_file &file, const proto_message &message,
+                                std::string_view full_name)
+{
+    stream << "void transcoder<" << full_name
+           << ">::json_to_pb_field(detail::json_istream &stream, detail::pb_ostream &out)\n{\n";
+
+    if (message.fields.empty() && message.maps.empty() && message.oneofs.empty())
+    {
+        stream << "\t(void)out;\n\tspb::json::detail::ignore_key_and_value(stream);\n}\n\n";
+        return;
+    }
+
+    stream << "\tusing namespace spb::json::detail;\n\tusing namespace spb::pb::detail;\n\n";
+    dump_json_key_dispatch(stream, message, [&](std::ostream &stream, const json_key &key)
+                           { dump_json_to_pb_case(stream, file, message, key, full_name); });
+    stream << "}\n\n";
+}
+
+void dump_transcoder_definition(std::ostream &stream, const proto_file &file, const proto_message &message,
+                                std::string_view full_name)
+{
+    if (!has_transcoder(file, message))
+        return;
+
+    dump_json_to_pb_definition(stream, file, message, full_name);
+
+    stream << "auto transcoder<" << full_name
+           << ">::pb_to_json_field(detail::pb_istream &in, detail::json_ostream &out, "
+              "spb::pb::detail::tag_type tag, detail::pb_to_json_state &state) -> bool\n{\n";
+
+    if (message.fields.empty() && message.maps.empty() && message.oneofs.empty())
+    {
+        stream << "\t(void)in;\n\t(void)out;\n\t(void)tag;\n\t(void)state;\n\treturn false;\n}\n\n";
+        return;
+    }
+
+    stream << "\tusing namespace spb::pb::detail;\n\n\tswitch (field_from_tag(tag))\n\t{\n";
+    for (const auto &field : message.fields)
+    {
+        dump_pb_to_json_case(stream, file, message, field, member_type(full_name, field.name.get_name()));
+    }
+    for (const auto &map : message.maps)
+    {
+        dump_pb_to_json_case(stream, file, message, map, member_type(full_name, map.name.get_name()));
+    }
+    for (const auto &oneof : message.oneofs)
+    {
+        for (size_t i = 0; i < oneof.fields.size(); ++i)
+        {
+            dump_pb_to_json_case(stream, file, message, oneof.fields[i], variant_type(oneof, i, full_name));
+        }
+    }
+    stream << "\tdefault:\n\t\treturn false;\n\t}\n}\n\n";
+}
+
+void dump_cpp_messages(std::ostream &stream, const proto_file &file, const proto_messages &messages,
+                       std::string_view parent, const func_dumper &dump_cpp);
+
+void dump_cpp_message(std::ostream &stream, const proto_file &file, const proto_message &message,
+                      std::string_view parent, const func_dumper &dump_cpp)
+{
+    const auto full_name = std::string(parent) + "::" + std::string(message.name.get_name());
+
+    dump_cpp(stream, file, message, full_name);
+    dump_cpp_messages(stream, file, message.messages, full_name, dump_cpp);
+}
+
+void dump_cpp_messages(std::ostream &stream, const proto_file &file, const proto_messages &messages,
+                       std::string_view parent, const func_dumper &dump_cpp)
+{
+    for (const auto &message : messages)
+    {
+        dump_cpp_message(stream, file, message, parent, dump_cpp);
+    }
+}
+
+void dump_cpp(std::ostream &stream, const proto_file &file, func_dumper dump_cpp)
+{
+    const auto str_namespace = file.package.name.get_name().empty()
+                                   ? std::string()
+                                   : "::" + std::string(file.package.name.get_name());
+    dump_cpp_messages(stream, file, file.package.messages, str_namespace, dump_cpp);
+}
+
+} // namespace
+
+void dump_transcode_header(const proto_file &file, std::ostream &stream)
+{
+    if (!has_transcoder(file, file.package.messages))
+        return;
+
+    stream << "namespace spb::transcode\n{\n";
+    dump_cpp(stream, file, dump_transcoder_declaration);
+    stream << "} // namespace spb::transcode\n";
+}
+
+void dump_transcode_cpp(const proto_file &file, const std::filesystem::path &header_file, std::ostream &stream)
+{
+    if (!has_transcoder(file, file.package.messages))
+        return;
+
+    stream << "#include \"" << header_file.string() << "\"\n"
+           << "#include <spb/transcode.hpp>\n"
+           << "#include <variant>\n\n"
+           << "namespace spb::transcode\n{\n"
+           << "using namespace std::literals;\n\n";
+    dump_cpp(stream, file, dump_transcoder_definition);
+    stream << "} // namespace spb::transcode\n";
+}
@@ -4,6 +4,9 @@
 #include <name.pb.h>
 #include <person.pb.h>
 #include <proto/options.pb.h>
+#include <proto/transcode.pb.h>
+#include <proto/validate.pb.h>
+#include <proto/view.pb.h>
 #include <scalar.pb.h>
 #include <spb/json/deserialize.hpp>
 #include <spb/json/serialize.hpp>
@@ -128,6 +131,256 @@ TEST_CASE("json")
         CHECK(hash3 != hash2);
         CHECK(hash3 != hash);
     }
+    SUBCASE("key_hash")
+    {
+        using spb::json::detail::key_hash;
+
+        //- all bytes of keys up to 16 bytes are hashed, longer keys by their first and last 8 bytes
+        CHECK(key_hash("name", 0) != key_hash("nama", 0));
+        CHECK(key_hash("name", 0) != key_hash("name_", 0));
+        CHECK(key_hash("l1_dcache_misses", 0) != key_hash("l1_icache_misses", 0));
+        CHECK(key_hash("branch_load_misses", 0) != key_hash("branch_xxxx_misses", 1));
+        CHECK(key_hash("name", 0) != key_hash("name", 1));
+        CHECK(key_hash({}, 0) == key_hash({}, 0));
+
+        static_assert(key_hash("hello", 0) == key_hash(std::string("hello"), 0));
+
+        //- escaped keys don't match any field
+        CHECK(spb::json::deserialize<Test::Name>(R"({"na\u006de":"x","name":"y"})"sv).name == "y");
+        CHECK(spb::json::deserialize<Test::Name>(R"({"bkfvdzz":"x","name":"y"})"sv).bkfvdzz == "x");
+    }
+    SUBCASE("expected_key")
+    {
+        //- keys are predicted in the serialization order, any other order still works
+        const auto in_order =
+            R"({"name":"John","id":1,"email":"a@b","phones":[{"number":"1","type":"WORK"}]})"sv;
+        const auto shuffled =
+            R"({"phones":[{"type":"WORK","number":"1"}],"email" : "a@b","x":1,"id":1,"name":"John"})"sv;
+        const auto person = spb::json::deserialize<PhoneBook::Person>(in_order);
+        CHECK(person.name == "John");
+        CHECK(spb::json::serialize<std::string>(person) == in_order);
+        const auto reordered = spb::json::deserialize<PhoneBook::Person>(shuffled);
+        CHECK(spb::json::serialize<std::string>(reordered) == in_order);
+
+        //- unknown and repeated keys in between
+        CHECK(spb::json::deserialize<PhoneBook::Person>(
+                  R"({"name":"Jack","unknown":[1,{"id":2}],"id":3,"id":1,"email":"a@b","name":"John"})"sv)
+                  .id == 1);
+
+        auto input  = in_order;
+        auto reader = [&input](void *p_data, size_t size) -> size_t
+        {
+            const auto chunk = std::min<size_t>({size, input.size(), 3});
+            memcpy(p_data, input.data(), chunk);
+            input.remove_prefix(chunk);
+            return chunk;
+        };
+        const auto from_reader = spb::json::deserialize<PhoneBook::Person>(reader);
+        CHECK(spb::json::serialize<std::string>(from_reader) == in_order);
+    }
+    SUBCASE("white spaces behind values")
+    {
+        const auto pretty =
+            R"({ "name" : "John" , "id" : 42 , "phones" : [ { "number" : "1" , "type" : "HOME" } ] })"sv;
+        const auto person = spb::json::deserialize<PhoneBook::Person>(pretty);
+        CHECK(person.name == "John");
+        CHECK(person.id == 42);
+        REQUIRE(person.phones.size() == 1);
+        CHECK(person.phones[0].type == PhoneBook::Person::PhoneType::HOME);
+        CHECK_NOTHROW(spb::json::validate<PhoneBook::Person>(pretty));
+
+        CHECK(spb::json::deserialize<Test::Scalar::RepBool>(R"({ "value" : [ true , false ] })"sv).value ==
+              std::vector<bool>{true, false});
+        const auto bytes = R"({ "value" : [ "MDEyMw==" , "" ] })"sv;
+        CHECK(spb::json::deserialize<Test::Scalar::RepBytes>(bytes).value ==
+              std::vector<std::vector<std::byte>>{to_bytes("0123"), {}});
+    }
+    SUBCASE("invalid utf8 string")
+    {
+        CHECK_THROWS((void)spb::json::deserialize<PhoneBook::Person>("{\"name\":\"h\x80\"}"sv));
+        CHECK_THROWS((void)spb::json::deserialize<PhoneBook::Person>("{\"name\":\"\\nh\x80\"}"sv));
+    }
+    SUBCASE("structural_index")
+    {
+        using spb::json::detail::build_structural_index;
+        CHECK(build_structural_index(R"( {"a\"" : [1, true]} )"sv) ==
+              std::vector<uint32_t>{1, 2, 6, 8, 10, 11, 12, 14, 18, 19, 21, 21});
+        CHECK(build_structural_index(""sv) == std::vector<uint32_t>{0, 0});
+
+        //- strings with white spaces, escapes and structural characters, spanning several 64 bytes blocks
+        const auto pretty = std::string(R"({
+            "name" : "John \"{[ ]}\" ,: \\\\",
+            "unknown" : { "x" : [ 1 , -2.5e3 , null , "  \\" ] },
+            "email"   :   "a very long e-mail address which does not fit into a single block @ example.com"  ,
+            "phones" : [
+                { "number" : "1\n2", "type" : "WORK" },
+                { "number" : "3",  "type"  :  "HOME" }
+            ],
+            "id" : 42
+        }
+        )");
+        const auto options = spb::json::deserialize_options{.structural_index = true};
+        const auto plain   = spb::json::deserialize<PhoneBook::Person>(pretty);
+        const auto indexed = spb::json::deserialize<PhoneBook::Person>(pretty, options);
+        CHECK(indexed.name == R"(John "{[ ]}" ,: \\)");
+        CHECK(indexed.phones.size() == 2);
+        CHECK(indexed.phones[1].number == "3");
+        CHECK(spb::json::serialize<std::string>(indexed) == spb::json::serialize<std::string>(plain));
+
+        CHECK_THROWS((void)spb::json::deserialize<PhoneBook::Person>(R"({ "name" : "John"  "id" : 1 })"sv,
+                                                                    options));
+        CHECK_THROWS((void)spb::json::deserialize<PhoneBook::Person>(R"({ "name" : "John )"sv, options));
+    }
+    SUBCASE("skip_value")
+    {
+        //- unknown values with brackets in strings, escaped quotes and backslashes, spanning many reader refills
+        auto nested = std::string(R"({"a":["]", "\"}", "\\", {"b":[[], {}]}], "c" : -1.5e-3 , "d":null})");
+        for (auto i = 0; i < 6; ++i)
+            nested = R"({"x" : [)" + nested + "," + nested + R"(], "s" : "\\\"{" })";
+
+        const auto json = R"({"unknown":)" + nested + R"(, "u2" : true, "u3":-12 ,"u4":"}","name":"John"})";
+        const auto options = spb::json::deserialize_options{.structural_index = true};
+        CHECK(spb::json::deserialize<PhoneBook::Person>(json).name == "John");
+        CHECK(spb::json::deserialize<PhoneBook::Person>(json, options).name == "John");
+        CHECK_NOTHROW(spb::json::validate<PhoneBook::Person>(json));
+
+        for (auto chunk_size : {size_t(1), size_t(7), size_t(64), size_t(1000)})
+        {
+            auto input  = std::string_view(json);
+            auto reader = [&input, chunk_size](void *p_data, size_t size) -> size_t
+            {
+                const auto chunk = std::min({size, input.size(), chunk_size});
+                memcpy(p_data, input.data(), chunk);
+                input.remove_prefix(chunk);
+                return chunk;
+            };
+            CHECK(spb::json::deserialize<PhoneBook::Person>(reader).name == "John");
+        }
+
+        //- unterminated values
+        for (const auto &invalid : {R"({"unknown":[1,{"a":"]"})", R"({"unknown":"x)", R"({"unknown":})"})
+        {
+            CHECK_THROWS((void)spb::json::deserialize<PhoneBook::Person>(std::string_view(invalid)));
+            CHECK_THROWS((void)spb::json::deserialize<PhoneBook::Person>(std::string_view(invalid), options));
+        }
+        //- malformed literals are rejected when skipping, same as by validation
+        for (const auto &invalid : {R"({"unknown":-,"name":"John"})", R"({"unknown":--1,"name":"John"})",
+                                    R"({"unknown":1e,"name":"John"})", R"({"unknown":1e+})",
+                                    R"({"unknown":1.2.3,"name":"John"})",
+                                    R"({"unknown":1-2})", "{\"unknown\":\xc3\xa9}"})
+        {
+            CHECK_THROWS((void)spb::json::deserialize<PhoneBook::Person>(std::string_view(invalid)));
+            CHECK_THROWS(spb::json::validate<PhoneBook::Person>(std::string_view(invalid)));
+        }
+        const auto numbers = R"({"u":0,"v":-0.5E+10,"w":7e3 ,"name":"John"})"sv;
+        CHECK(spb::json::deserialize<PhoneBook::Person>(numbers).name == "John");
+        CHECK_THROWS((void)spb::json::deserialize<PhoneBook::Person>(R"({"unknown":1.,"name":"John"})"sv));
+        //- content is not checked when skipping, but validation does
+        CHECK_THROWS(spb::json::validate<PhoneBook::Person>(R"({"unknown":[1,}],"name":"John"})"sv));
+    }
+    SUBCASE("reader_buffer")
+    {
+        auto person = PhoneBook::Person{.name = std::string(300, 'n'), .id = 7, .email = "a\"@b"};
+        for (auto i = 0; i < 20; ++i)
+            person.phones.push_back({.number = std::to_string(i)});
+        const auto json = spb::json::serialize<std::string>(person);
+
+        for (auto chunk_size : {size_t(1), size_t(7), size_t(255), size_t(300), json.size()})
+        {
+            auto input  = std::string_view(json);
+            auto reader = [&input, chunk_size](void *p_data, size_t size) -> size_t
+            {
+                const auto chunk = std::min({size, input.size(), chunk_size});
+                memcpy(p_data, input.data(), chunk);
+                input.remove_prefix(chunk);
+                return chunk;
+            };
+            const auto from_reader =
+                spb::json::deserialize<PhoneBook::Person>(reader, {.reader_buffer_size = 1});
+            CHECK(spb::json::serialize<std::string>(from_reader) == json);
+
+            input       = json;
+            auto buffer = std::array<char, spb::io::buffered_reader::MIN_BUFFER_SIZE + 10>();
+            const auto from_buffer =
+                spb::json::deserialize<PhoneBook::Person>(reader, {.reader_buffer = buffer});
+            CHECK(spb::json::serialize<std::string>(from_buffer) == json);
+
+            //- chunks are lent by the reader and parsed in place
+            input             = json;
+            auto chunk_reader = [&input, chunk_size]() -> std::string_view
+            {
+                const auto chunk = input.substr(0, chunk_size);
+                input.remove_prefix(chunk.size());
+                return chunk;
+            };
+            auto message = PhoneBook::Person();
+            CHECK(spb::json::deserialize(message, chunk_reader) == json.size());
+            CHECK(spb::json::serialize<std::string>(message) == json);
+        }
+
+        auto small_buffer = std::array<char, spb::io::buffered_reader::MIN_BUFFER_SIZE - 1>();
+        auto empty_reader = [](void *, size_t) -> size_t { return 0; };
+        CHECK_THROWS_AS(
+            (void)spb::json::deserialize<PhoneBook::Person>(empty_reader, {.reader_buffer = small_buffer}),
+            std::length_error);
+    }
+    SUBCASE("for_each")
+    {
+        auto people = std::vector<PhoneBook::Person>();
+        for (auto i = 0; i < 7; ++i)
+            people.push_back({.name = "n" + std::to_string(i), .id = i, .phones = {{.number = "1"}}});
+
+        auto array  = std::string(" [\n");
+        auto ndjson = std::string();
+        for (const auto &person : people)
+        {
+            array += (array.size() > 3 ? " , " : "") + spb::json::serialize<std::string>(person);
+            ndjson += spb::json::serialize<std::string>(person) + "\r\n";
+        }
+        array += "\n] ";
+
+        auto ids       = std::vector<int32_t>();
+        auto on_person = [&ids](PhoneBook::Person &&person) { ids.push_back(*person.id); };
+        for (const auto &json : {array, ndjson})
+        {
+            ids.clear();
+            CHECK(spb::json::for_each<PhoneBook::Person>(json, on_person) == 7);
+            CHECK(ids == std::vector<int32_t>{0, 1, 2, 3, 4, 5, 6});
+
+            for (auto chunk_size : {size_t(1), size_t(5), json.size()})
+            {
+                auto input  = std::string_view(json);
+                auto reader = [&input, chunk_size](void *p_data, size_t size) -> size_t
+                {
+                    const auto chunk = std::min({size, input.size(), chunk_size});
+                    memcpy(p_data, input.data(), chunk);
+                    input.remove_prefix(chunk);
+                    return chunk;
+                };
+                ids.clear();
+                CHECK(spb::json::for_each<PhoneBook::Person>(reader, on_person) == 7);
+                CHECK(ids == std::vector<int32_t>{0, 1, 2, 3, 4, 5, 6});
+            }
+
+            auto batches  = std::vector<size_t>();
+            auto on_batch = [&](std::span<PhoneBook::Person> batch)
+            {
+                batches.push_back(batch.size());
+                for (auto &person : batch)
+                    CHECK(person.name == "n" + std::to_string(*person.id));
+            };
+            CHECK(spb::json::for_each<PhoneBook::Person>(json, on_batch, 3) == 7);
+            CHECK(batches == std::vector<size_t>{3, 3, 1});
+        }
+
+        CHECK_THROWS_AS(spb::json::for_each<PhoneBook::Person>(array, on_person, 3), std::invalid_argument);
+        CHECK(spb::json::for_each<PhoneBook::Person>(" [ ] "sv, on_person) == 0);
+        CHECK(spb::json::for_each<PhoneBook::Person>(" \n "sv, on_person) == 0);
+        CHECK_THROWS(spb::json::for_each<PhoneBook::Person>(R"([{"id":1},])"sv, on_person));
+        CHECK_THROWS(spb::json::for_each<PhoneBook::Person>(R"([{"id":1} {"id":2}])"sv, on_person));
+        CHECK_THROWS(spb::json::for_each<PhoneBook::Person>(R"([{"id":1})"sv, on_person));
+        CHECK_THROWS(spb::json::for_each<PhoneBook::Person>("{\"id\":1}\n[]"sv, on_person));
+    }
     SUBCASE("deserialize")
     {
         SUBCASE("options")
@@ -376,8 +629,9 @@ TEST_CASE("json")
                 CHECK_THROWS((void)spb::json::deserialize<Test::Name>(R"({"value"})"sv));
                 CHECK_THROWS(
                     (void)spb::json::deserialize<Test::Name>(R"({"value":{"key":"value", "key2":[42]})"sv));
-                CHECK_THROWS((void)spb::json::deserialize<Test::Name>(R"({"value":{"key":}})"sv));
-                CHECK_THROWS((void)spb::json::deserialize<Test::Name>(R"({"value":{"key"}})"sv));
+                //- unknown values are skipped by their brackets only, validation checks them fully
+                CHECK_THROWS(spb::json::validate<Test::Name>(R"({"value":{"key":}})"sv));
+                CHECK_THROWS(spb::json::validate<Test::Name>(R"({"value":{"key"}})"sv));
                 CHECK_THROWS((void)spb::json::deserialize<Test::Name>(R"({"value":{"key":"value")"sv));
                 CHECK_THROWS((void)spb::json::deserialize<Test::Name>(R"({"value":{"key":"value",)"sv));
             }
@@ -400,6 +654,40 @@ TEST_CASE("json")
                 CHECK(person.phones[0].type == PhoneBook::Person::PhoneType::HOME);
             }
         }
+        SUBCASE("streaming")
+        {
+            constexpr auto json =
+                R"({"name": "John Doe", "phones": [{"number": "1"}, {"number": "2"}, {"number": "3"}], "id": 1})"sv;
+
+            auto numbers = std::vector<std::string>();
+            auto handler = [&numbers](PhoneBook::Person::PhoneNumber &&phone)
+            { numbers.push_back(phone.number); };
+
+            const auto person = spb::json::deserialize_streaming<PhoneBook::Person>(
+                json, spb::on_element(&PhoneBook::Person::phones, handler));
+            CHECK(person.name == "John Doe");
+            CHECK(person.id == 1);
+            CHECK(person.phones.empty());
+            CHECK(numbers == std::vector<std::string>{"1", "2", "3"});
+
+            SUBCASE("reader")
+            {
+                numbers.clear();
+                auto input  = std::string_view(json);
+                auto reader = [&input](void *p_data, size_t size) -> size_t
+                {
+                    const auto chunk = std::min<size_t>({size, input.size(), 5});
+                    memcpy(p_data, input.data(), chunk);
+                    input.remove_prefix(chunk);
+                    return chunk;
+                };
+                const auto person2 = spb::json::deserialize_streaming<PhoneBook::Person>(
+                    reader, spb::on_element(&PhoneBook::Person::phones, handler));
+                CHECK(person2.name == "John Doe");
+                CHECK(person2.phones.empty());
+                CHECK(numbers == std::vector<std::string>{"1", "2", "3"});
+            }
+        }
         SUBCASE("enum")
         {
             CHECK(spb::json::deserialize<PhoneBook::Person::PhoneType>("\"HOME\""sv) ==
@@ -989,6 +1277,31 @@ TEST_CASE("json")
                       R"("\"\\/\b\f\n\r\t")");
                 CHECK(spb::json::serialize<std::string, std::string>("\"hello\t") == R"("\"hello\t")");
             }
+            SUBCASE("unicode")
+            {
+                CHECK(spb::json::serialize<std::string, std::string>("\x01\x1f") == R"("\u0001\u001f")");
+                CHECK(spb::json::serialize<std::string, std::string>(
+                          "h\xc3\x8c\xE3\x9B\x8B\xF0\x90\x87\xB3o") == R"("h\u00cc\u36cb\ud800\uddf3o")");
+                CHECK_THROWS((void)spb::json::serialize<std::string, std::string>("h\x80"));
+                CHECK_THROWS((void)spb::json::serialize<std::string, std::string>("h\xc3"));
+                CHECK_THROWS((void)spb::json::serialize<std::string, std::string>("h\xc3\x8c\xc3"));
+            }
+            SUBCASE("long")
+            {
+                //- escapes at every position of (and across) 8 and 16 bytes blocks
+                for (auto i = size_t(0); i < 40; i++)
+                {
+                    auto value = std::string(40, 'a');
+                    auto json  = std::string(40, 'a');
+                    value[i]   = '"';
+                    json.replace(i, 1, R"(\")");
+                    CHECK(spb::json::serialize<std::string, std::string>(value) == '"' + json + '"');
+
+                    value.replace(i, 1, "\xc3\x8c");
+                    json.replace(i, 2, R"(\u00cc)");
+                    CHECK(spb::json::serialize<std::string, std::string>(value) == '"' + json + '"');
+                }
+            }
             SUBCASE("optional")
             {
                 CHECK(spb::json::serialize<std::string, std::optional<std::string>>(std::nullopt) == "");
@@ -1171,5 +1484,328 @@ TEST_CASE("json")
             CHECK(spb::json::serialize(Test::Name{}) == R"({})");
             CHECK(spb::json::serialize_size(Test::Name{}) == 2);
         }
+        SUBCASE("field mask")
+        {
+            const auto person = PhoneBook::Person{
+                .name   = "John Doe",
+                .id     = 123,
+                .email  = "QXUeh@example.com",
+                .phones = {{.number = "555-4321", .type = PhoneBook::Person::PhoneType::HOME},
+                           {.number = "555-1234", .type = PhoneBook::Person::PhoneType::WORK}},
+            };
+            CHECK(spb::json::serialize<spb::fields<1, 3>>(person) ==
+                  R"({"name":"John Doe","email":"QXUeh@example.com"})");
+            CHECK(spb::json::serialize<spb::fields<>>(person) == R"({})");
+
+            const auto mask = spb::field_mask{{2}, {4, 2}};
+            const auto json = std::string(R"({"id":123,"phones":[{"type":"HOME"},{"type":"WORK"}]})");
+            CHECK(spb::json::serialize(person, {.mask = &mask}) == json);
+            CHECK(spb::json::serialize_size(person, {.mask = &mask}) == json.size());
+
+            auto written = std::string();
+            CHECK(spb::json::serialize(
+                      person, [&](const void *p_data, size_t size)
+                      { written.append(static_cast<const char *>(p_data), size); }, {.mask = &mask}) ==
+                  json.size());
+            CHECK(written == json);
+        }
+        SUBCASE("growable")
+        {
+            auto person = PhoneBook::Person{.name = std::string(1000, 'a'), .email = "\"\\"};
+            for (auto i = 0; i < 100; i++)
+                person.phones.push_back({.number = std::to_string(i)});
+
+            const auto size = spb::json::serialize_size(person);
+            auto json       = std::string();
+            CHECK(spb::json::serialize(person, json) == size);
+            CHECK(json.size() == size);
+            CHECK(spb::json::serialize(spb::json::deserialize<PhoneBook::Person>(json)) == json);
+
+            //- reused container is overwritten
+            auto buffer = std::string(4096, 'x');
+            CHECK(spb::json::serialize(person, buffer) == size);
+            CHECK(buffer == json);
+            CHECK(spb::json::serialize(Test::Name{}, buffer) == 2);
+            CHECK(buffer == "{}");
+
+            auto bytes = std::vector<std::byte>();
+            CHECK(spb::json::serialize(person, bytes) == size);
+            CHECK(std::string_view((const char *)bytes.data(), bytes.size()) == json);
+        }
+        SUBCASE("escape_unicode")
+        {
+            constexpr auto options = spb::json::serialize_options{.escape_unicode = false};
+
+            auto person     = PhoneBook::Person{.name  = "h\xc3\x8c\xE3\x9B\x8B\xF0\x90\x87\xB3o",
+                                                .email = "\"\x01"};
+            const auto json = std::string(R"({"name":"h)") + "\xc3\x8c\xE3\x9B\x8B\xF0\x90\x87\xB3" +
+                              R"(o","email":"\"\u0001"})";
+
+            CHECK(spb::json::serialize_size(person, options) == json.size());
+            CHECK(spb::json::serialize<std::string>(person, options) == json);
+            CHECK(spb::json::deserialize<PhoneBook::Person>(json).name == person.name);
+
+            auto buffer = std::string(json.size(), '\0');
+            CHECK(spb::json::serialize(person, buffer.data(), options) == json.size());
+            CHECK(buffer == json);
+
+            auto written = std::string();
+            CHECK(spb::json::serialize(
+                      person, [&](const void *p_data, size_t size)
+                      { written.append(static_cast<const char *>(p_data), size); }, options) == json.size());
+            CHECK(written == json);
+
+            //- default stays ASCII only
+            CHECK(spb::json::serialize<std::string>(person) ==
+                  R"({"name":"h\u00cc\u36cb\ud800\uddf3o","email":"\"\u0001"})");
+
+            person.name = "h\xc3";
+            CHECK_THROWS((void)spb::json::serialize_size(person, options));
+            CHECK_THROWS((void)spb::json::serialize<std::string>(person, options));
+        }
+    }
+    SUBCASE("string view")
+    {
+        using namespace UnitTest::view;
+
+        const auto json = std::string(R"({ "name" : "John", "tags" : ["a", "b\"c"], "id" : 1, "nick":"J" })");
+
+        const auto is_in_json = [&json](std::string_view str)
+        { return str.data() >= json.data() && str.data() + str.size() <= json.data() + json.size(); };
+
+        const auto owned = spb::json::deserialize<Owned>(json);
+        CHECK(*owned.name == "John");
+        CHECK(owned.name->is_borrowed());
+        CHECK(is_in_json(*owned.name));
+        CHECK(owned.tags.size() == 2);
+        CHECK(owned.tags[0] == "a");
+        CHECK(owned.tags[0].is_borrowed());
+        //- escaped string is unescaped into an owned copy
+        CHECK(owned.tags[1] == "b\"c");
+        CHECK(!owned.tags[1].is_borrowed());
+        CHECK(*owned.nick == "J");
+
+        const auto indexed = spb::json::deserialize<Owned>(json, {.structural_index = true});
+        CHECK(is_in_json(*indexed.name));
+        CHECK(indexed.tags[1] == "b\"c");
+        CHECK(spb::json::serialize(indexed) == spb::json::serialize(owned));
+        CHECK(spb::json::serialize(owned) == R"({"name":"John","tags":["a","b\"c"],"id":1,"nick":"J"})");
+
+        const auto borrowed = spb::json::deserialize<Borrowed>(R"({"name":"John","tags":["a","b"]})"sv);
+        CHECK(*borrowed.name == "John");
+        CHECK(borrowed.tags == std::vector<std::string_view>{"a", "b"});
+        CHECK_THROWS((void)spb::json::deserialize<Borrowed>(json));
+        CHECK_THROWS(spb::json::validate<Borrowed>(json));
+        CHECK_NOTHROW(spb::json::validate<Owned>(json));
+        CHECK_THROWS((void)spb::json::deserialize<Owned>(R"({"name":"John)"sv));
+        CHECK_THROWS((void)spb::json::deserialize<Owned>(R"({"name":"h\x80"})"sv));
+
+        //- a reader has no stable input, so the strings are copied
+        auto input  = std::string_view(json);
+        auto reader = [&input](void *p_data, size_t size) -> size_t
+        {
+            const auto chunk = std::min(size, input.size());
+            memcpy(p_data, input.data(), chunk);
+            input.remove_prefix(chunk);
+            return chunk;
+        };
+        const auto from_reader = spb::json::deserialize<Owned>(reader);
+        CHECK(*from_reader.name == "John");
+        CHECK(!from_reader.name->is_borrowed());
+        CHECK(spb::json::serialize(from_reader) == spb::json::serialize(owned));
+        //- std::string_view can't point into a reader, it is rejected at compile time
+        using spb::json::detail::istream_reader;
+        static_assert(!spb::json::detail::message_deserializable<istream_reader, Borrowed>);
+        static_assert(spb::json::detail::message_deserializable<istream_reader, Owned>);
+    }
+    SUBCASE("transcode")
+    {
+        using namespace UnitTest::transcode;
+
+        auto person = Person{
+            .name    = "John \"Doe\"\n",
+            .id      = 42,
+            .balance = -1234567,
+            .flags   = 0xdeadbeef,
+            .score   = 0.5,
+            .active  = true,
+            .avatar  = std::vector{std::byte(0), std::byte(0xff), std::byte(1)},
+            .kind    = Kind::WORK,
+            .tags    = {"a", "b\tc"},
+            .deltas  = {-1, 0, 1},
+            .phones  = {{.number = "555-4321", .kind = Kind::HOME}, {.number = "555-1234"}},
+            .main    = Phone{.number = "123"},
+            .kinds   = {Kind::HOME, Kind::WORK},
+            .opaque  = Opaque{.note = "opaque", .values = {1, 2, 3}},
+            .bits    = {true, false},
+            .ratio   = 1.25F,
+            .attrs   = {{"x", 1}, {"y z", 2}},
+            .by_id   = {{7, Phone{.number = "7"}}, {-8, Phone{.kind = Kind::WORK}}},
+            .contact = decltype(Person::contact){std::in_place_index<2>, Phone{.number = "999"}},
+        };
+
+        SUBCASE("pb to json")
+        {
+            const auto protobuf = spb::pb::serialize(person);
+            const auto expected = spb::json::serialize(person);
+            CHECK(spb::transcode::pb_to_json<Person>(protobuf) == expected);
+
+            auto json       = std::string();
+            const auto size = spb::transcode::pb_to_json<Person>(
+                protobuf, [&](const void *p_data, size_t size)
+                { json.append(static_cast<const char *>(p_data), size); });
+            CHECK(size == expected.size());
+            CHECK(json == expected);
+
+            person.contact = decltype(Person::contact){std::in_place_index<1>, "john@doe"};
+            CHECK(spb::transcode::pb_to_json<Person>(spb::pb::serialize(person)) ==
+                  spb::json::serialize(person));
+
+            CHECK(spb::transcode::pb_to_json<Person>(spb::pb::serialize(Person{})) ==
+                  spb::json::serialize(Person{}));
+            CHECK(spb::transcode::pb_to_json<Phone>(std::string()) == "{}");
+        }
+        SUBCASE("pb to json unknown fields")
+        {
+            //- field 3 is unknown for Phone
+            const auto protobuf = spb::pb::serialize(Phone{.number = "1"}) + "\x18\x01"s;
+            CHECK(spb::transcode::pb_to_json<Phone>(protobuf) == R"({"number":"1"})");
+        }
+        SUBCASE("pb to json invalid")
+        {
+            const auto protobuf = spb::pb::serialize(person);
+            CHECK_THROWS((void)spb::transcode::pb_to_json<Person>(protobuf.substr(0, protobuf.size() - 1)));
+            CHECK_THROWS((void)spb::transcode::pb_to_json<Phone>("\x0a\x02\xc3\x28"s));
+        }
+        SUBCASE("pb to json duplicate fields")
+        {
+            //- tags = 9, name = 1
+            CHECK(spb::transcode::pb_to_json<Person>("\x4a\x01\x61\x4a\x01\x62\x0a\x01\x6e"s) ==
+                  R"({"tags":["a","b"],"name":"n"})");
+            //- interleaved elements of a repeated field would be written as two "tags" keys
+            CHECK_THROWS((void)spb::transcode::pb_to_json<Person>("\x4a\x01\x61\x0a\x01\x6e\x4a\x01\x62"s));
+            //- singular field found twice
+            CHECK_THROWS((void)spb::transcode::pb_to_json<Person>("\x0a\x01\x61\x0a\x01\x62"s));
+            CHECK_THROWS((void)spb::transcode::pb_to_json<Person>("\x0a\x00\x0a\x01\x62"s));
+            CHECK_THROWS((void)spb::transcode::pb_to_json<Phone>("\x10\x01\x10\x02"s));
+        }
+        SUBCASE("json to pb")
+        {
+            const auto json     = spb::json::serialize(person);
+            const auto expected = spb::pb::serialize(person);
+            CHECK(spb::transcode::json_to_pb<Person>(json) == expected);
+
+            auto protobuf   = std::string();
+            auto writes     = std::vector<std::string>();
+            const auto size = spb::transcode::json_to_pb<Person>(
+                json, [&](const void *p_data, size_t size)
+                {
+                    writes.emplace_back(static_cast<const char *>(p_data), size);
+                    protobuf += writes.back();
+                });
+            CHECK(size == expected.size());
+            CHECK(protobuf == expected);
+            //- written field by field
+            REQUIRE(writes.size() > 1);
+            CHECK(writes.front() == spb::pb::serialize(Person{.name = person.name}));
+
+            person.contact = decltype(Person::contact){std::in_place_index<1>, "john@doe"};
+            CHECK(spb::transcode::json_to_pb<Person>(spb::json::serialize(person)) == spb::pb::serialize(person));
+
+            //- lengths which do not fit into the reserved byte
+            person.name      = std::string(300, 'n');
+            person.main      = Phone{.number = std::string(200, 'm')};
+            person.phones[1] = Phone{.number = std::string(20000, 'p')};
+            CHECK(spb::transcode::json_to_pb<Person>(spb::json::serialize(person)) == spb::pb::serialize(person));
+
+            CHECK(spb::transcode::json_to_pb<Person>("{}"sv).empty());
+            CHECK(spb::transcode::json_to_pb<Person>(spb::json::serialize(Person{})) ==
+                  spb::pb::serialize(Person{}));
+            CHECK(spb::transcode::json_to_pb<Phone, std::vector<std::byte>>(R"({"number":"1"})"sv) ==
+                  spb::pb::serialize<std::vector<std::byte>>(Phone{.number = "1"}));
+        }
+        SUBCASE("json to pb keys")
+        {
+            //- fields are written in the JSON order
+            const auto protobuf = spb::transcode::json_to_pb<Person>(
+                R"({ "Ratio" : 1.5, "name": "a\u0041", "unknown": [1, {"a": null}], "main": null,
+                     "phones": [{"kind": 1}, {}], "email": "e", "bits": null, "deltas": [] })"sv);
+            CHECK(protobuf.starts_with("\xa5\x01"sv));
+            CHECK(spb::pb::serialize(spb::pb::deserialize<Person>(protobuf)) ==
+                  spb::pb::serialize(Person{.name    = "aA",
+                                            .phones  = {Phone{.kind = Kind::HOME}, Phone{}},
+                                            .ratio   = 1.5F,
+                                            .contact = decltype(Person::contact){std::in_place_index<1>, "e"}}));
+            CHECK(spb::transcode::json_to_pb<Person>(R"({"ratio":1.5})"sv) ==
+                  spb::pb::serialize(Person{.ratio = 1.5F}));
+        }
+        SUBCASE("json to pb invalid")
+        {
+            const auto json = spb::json::serialize(person);
+            CHECK_THROWS((void)spb::transcode::json_to_pb<Person>(json.substr(0, json.size() - 1)));
+            CHECK_THROWS((void)spb::transcode::json_to_pb<Phone>(R"({"number":1})"sv));
+            CHECK_THROWS((void)spb::transcode::json_to_pb<Phone>(R"({"number":"\xc3\x28"})"s));
+            CHECK_THROWS((void)spb::transcode::json_to_pb<Person>(R"({"avatar":"AP8"})"sv));
+            CHECK_THROWS((void)spb::transcode::json_to_pb<Person>(R"({"kind":"OFFICE"})"sv));
+        }
+    }
+    SUBCASE("validate")
+    {
+        using namespace UnitTest::validate;
+
+        auto order = Order{.number  = 42,
+                           .level   = Level::HIGH,
+                           .note    = "note",
+                           .items   = {{.id = 1, .label = "a"}, {.id = 2}},
+                           .codes   = {1, 2, 3},
+                           .blob    = std::vector{std::byte(1), std::byte(2)},
+                           .flags   = 5,
+                           .attrs   = {{"k", Level::LOW}},
+                           .contact = Item{.id = 3}};
+
+        SUBCASE("valid")
+        {
+            CHECK_NOTHROW(spb::json::validate<Order>(spb::json::serialize(order)));
+            CHECK_NOTHROW(spb::json::validate<Order>(spb::json::serialize(Order{})));
+            CHECK_NOTHROW(spb::json::validate<Order>(
+                R"({"number":"1", "level":1, "flags":7, "note":"aé\"", "blob":null, "codes":null,
+                    "unknown":[1, {"a":null}], "items":[{"id":1}], "attrs":{"x":"HIGH"}, "owner":{"id":2}})"sv));
+        }
+        SUBCASE("required")
+        {
+            CHECK_THROWS(spb::json::validate<Order>(R"({"number":1,"level":"LOW"})"sv));
+            CHECK_THROWS(spb::json::validate<Order>(R"({"number":1,"level":"LOW","flags":1,"items":[{}]})"sv));
+            CHECK_THROWS(spb::json::validate<Item>(R"({})"sv));
+        }
+        SUBCASE("max size")
+        {
+            order.note = "123456789";
+            CHECK_THROWS(spb::json::validate<Order>(spb::json::serialize(order)));
+            order.note = "12345678";
+            order.blob = std::vector<std::byte>(5);
+            CHECK_THROWS(spb::json::validate<Order>(spb::json::serialize(order)));
+            order.blob->pop_back();
+            CHECK_NOTHROW(spb::json::validate<Order>(spb::json::serialize(order)));
+        }
+        SUBCASE("max count")
+        {
+            order.codes.push_back(4);
+            CHECK_THROWS(spb::json::validate<Order>(spb::json::serialize(order)));
+            order.codes.pop_back();
+            order.items.push_back({.id = 3});
+            CHECK_THROWS(spb::json::validate<Order>(spb::json::serialize(order)));
+        }
+        SUBCASE("invalid")
+        {
+            const auto json = spb::json::serialize(order);
+            CHECK_THROWS(spb::json::validate<Order>(json.substr(0, json.size() - 1)));
+            CHECK_THROWS(spb::json::validate<Item>(R"({"id":1,"label":"\xc3\x28"})"s));
+            CHECK_THROWS(spb::json::validate<Item>(R"({"id":"x"})"sv));
+            CHECK_THROWS(spb::json::validate<Order>(R"({"number":1,"level":"MEDIUM","flags":1})"sv));
+            CHECK_THROWS(spb::json::validate<Order>(R"({"number":1,"level":0,"flags":8})"sv));
+            CHECK_THROWS(spb::json::validate<Order>(R"({"number":1,"level":0,"flags":1,"blob":"A*=="})"sv));
+            CHECK_THROWS(spb::json::validate<Order>(R"({"number":1,"level":0,"flags":1,"blob":"A=A="})"sv));
+            CHECK_THROWS(spb::json::validate<Order>(R"({"number":1,"level":0,"flags":1,"attrs":{"k":2}})"sv));
+        }
     }
 }
@@ -4,16 +4,24 @@
 #include <name.pb.h>
 #include <person.pb.h>
 #include <proto/array.pb.h>
+#include <proto/builder.pb.h>
+#include <proto/cached.pb.h>
 #include <proto/enum.pb.h>
 #include <proto/map.pb.h>
 #include <proto/options.pb.h>
+#include <proto/raw.pb.h>
 #include <proto/simd.pb.h>
+#include <proto/stream.pb.h>
+#include <proto/unknown.pb.h>
+#include <proto/validate.pb.h>
+#include <proto/view.pb.h>
 #include <reserved.pb.h>
 #include <scalar.pb.h>
 #include <span>
 #include <spb/pb.hpp>
 #include <string>
 #include <string_view>
+#include <thread>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
@@ -124,6 +132,14 @@ auto operator==(const Data &lhs, const Data &rhs) noexcept -> bool
 }
 } // namespace UnitTest::array
 
+namespace UnitTest::raw
+{
+auto operator==(const Payload &lhs, const Payload &rhs) noexcept -> bool
+{
+    return lhs.name == rhs.name && lhs.id == rhs.id;
+}
+} // namespace UnitTest::raw
+
 namespace UnitTest::map
 {
 auto operator==(const Int32Int32 &lhs, const Int32Int32 &rhs) noexcept -> bool
@@ -2388,4 +2404,908 @@ TEST_CASE("protobuf")
             }
         }
     }
+    SUBCASE("unknown fields")
+    {
+        const auto v2 = UnitTest::unknown::V2{.name  = "John",
+                                              .id    = -2,
+                                              .flags = 0x12345678,
+                                              .stamp = 0x1122334455667788,
+                                              .tags  = {"a", "bc"},
+                                              .delta = -3};
+        const auto protobuf = spb::pb::serialize(v2);
+
+        SUBCASE("round trip")
+        {
+            const auto v1 = spb::pb::deserialize<UnitTest::unknown::V1>(protobuf);
+            CHECK(v1.name == "John");
+            CHECK(v1.unknown_fields.size() == protobuf.size() - "\x0a\x04John"sv.size());
+            CHECK(spb::pb::serialize(v1) == protobuf);
+            CHECK(spb::pb::serialize_size(v1) == protobuf.size());
+
+            auto reader = [view = std::string_view(protobuf)](void *data, size_t size) mutable
+            {
+                const auto copy_size = std::min(view.size(), size);
+                memcpy(data, view.data(), copy_size);
+                view.remove_prefix(copy_size);
+                return copy_size;
+            };
+            auto v1_reader = spb::pb::deserialize<UnitTest::unknown::V1>(reader);
+            CHECK(v1_reader.unknown_fields == v1.unknown_fields);
+
+            const auto v2_copy = spb::pb::deserialize<UnitTest::unknown::V2>(spb::pb::serialize(v1));
+            CHECK(v2_copy.name == v2.name);
+            CHECK(v2_copy.id == v2.id);
+            CHECK(v2_copy.flags == v2.flags);
+            CHECK(v2_copy.stamp == v2.stamp);
+            CHECK(v2_copy.tags == v2.tags);
+            CHECK(v2_copy.delta == v2.delta);
+        }
+        SUBCASE("empty")
+        {
+            const auto empty = spb::pb::deserialize<UnitTest::unknown::Empty>(protobuf);
+            CHECK(empty.unknown_fields.size() == protobuf.size());
+            CHECK(spb::pb::serialize(empty) == protobuf);
+        }
+        SUBCASE("drop")
+        {
+            const auto v1 = spb::pb::deserialize<UnitTest::unknown::V1Drop>(protobuf);
+            CHECK(spb::pb::serialize(v1) == "\x0a\x04John");
+        }
+        SUBCASE("json")
+        {
+            const auto v1 = spb::pb::deserialize<UnitTest::unknown::V1>(protobuf);
+            CHECK(spb::json::serialize(v1) == R"({"name":"John"})");
+        }
+        SUBCASE("invalid")
+        {
+            CHECK_THROWS((void)spb::pb::deserialize<UnitTest::unknown::V1>("\x10\xff"sv));
+            CHECK_THROWS((void)spb::pb::deserialize<UnitTest::unknown::V1>("\x1d\x00\x00"sv));
+            CHECK_THROWS((void)spb::pb::deserialize<UnitTest::unknown::V1>("\x2a\x05hell"sv));
+            CHECK_THROWS((void)spb::pb::deserialize<UnitTest::unknown::V1>("\x2f\x05hello"sv));
+        }
+    }
+    SUBCASE("raw")
+    {
+        const auto payload = UnitTest::raw::Payload{.name = "John", .id = 42};
+        const auto decoded = UnitTest::raw::EnvelopeDecoded{
+            .seq = 1, .payload = payload, .items = {payload, {.name = "Jane"}}, .opt = payload};
+        const auto protobuf = spb::pb::serialize(decoded);
+
+        SUBCASE("serialize")
+        {
+            const auto envelope = UnitTest::raw::Envelope{
+                .seq     = 1,
+                .payload = spb::pb::raw<UnitTest::raw::Payload>(payload),
+                .items   = {spb::pb::raw<UnitTest::raw::Payload>(payload),
+                            spb::pb::raw<UnitTest::raw::Payload>({.name = "Jane"})},
+                .opt     = spb::pb::raw<UnitTest::raw::Payload>(payload)};
+            CHECK(spb::pb::serialize(envelope) == protobuf);
+            CHECK(spb::pb::serialize_size(envelope) == protobuf.size());
+            CHECK(spb::json::serialize(envelope) == spb::json::serialize(decoded));
+        }
+        SUBCASE("deserialize")
+        {
+            const auto envelope = spb::pb::deserialize<UnitTest::raw::Envelope>(protobuf);
+            CHECK(envelope.seq == 1);
+            CHECK(envelope.payload == spb::pb::raw<UnitTest::raw::Payload>(payload));
+            CHECK(envelope.payload->decode() == payload);
+            REQUIRE(envelope.items.size() == 2);
+            CHECK(envelope.items[1].decode() == UnitTest::raw::Payload{.name = "Jane"});
+            REQUIRE(envelope.opt.has_value());
+            CHECK(envelope.opt->decode() == payload);
+            CHECK(spb::pb::serialize(envelope) == protobuf);
+        }
+        SUBCASE("json")
+        {
+            const auto json     = spb::json::serialize(decoded);
+            const auto envelope = spb::json::deserialize<UnitTest::raw::Envelope>(json);
+            CHECK(envelope.payload->decode() == payload);
+            CHECK(spb::pb::serialize(envelope) == protobuf);
+            CHECK(spb::json::serialize(envelope) == json);
+        }
+    }
+    SUBCASE("cached")
+    {
+        const auto config = UnitTest::cached::Config{.name = "config", .values = {1, 2, 3}};
+        const auto plain  = UnitTest::cached::BroadcastPlain{.seq = 1, .config = config, .configs = {config}};
+        const auto protobuf = spb::pb::serialize(plain);
+
+        SUBCASE("serialize")
+        {
+            auto broadcast = UnitTest::cached::Broadcast{.seq = 1, .config = config, .configs = {config}};
+            CHECK(spb::pb::serialize_size(broadcast) == protobuf.size());
+            CHECK(spb::pb::serialize(broadcast) == protobuf);
+            CHECK(spb::pb::serialize(broadcast) == protobuf);
+            CHECK(spb::json::serialize(broadcast) == spb::json::serialize(plain));
+
+            const auto encoded = broadcast.config->encoded();
+            CHECK(std::string_view((const char *)encoded.data(), encoded.size()) == spb::pb::serialize(config));
+            CHECK(broadcast.config->encoded().data() == encoded.data());
+
+            broadcast.config->mutable_value().name = "changed";
+            auto changed = plain;
+            changed.config->name = "changed";
+            CHECK(spb::pb::serialize(broadcast) == spb::pb::serialize(changed));
+
+            const auto copy = broadcast;
+            CHECK(copy.config->encoded().data() != broadcast.config->encoded().data());
+            CHECK(spb::pb::serialize(copy) == spb::pb::serialize(changed));
+        }
+        SUBCASE("concurrent serialize")
+        {
+            const auto broadcast =
+                UnitTest::cached::Broadcast{.seq = 1, .config = config, .configs = {config}};
+            auto results = std::vector<std::string>(4);
+            {
+                auto threads = std::vector<std::jthread>();
+                for (auto &result : results)
+                    threads.emplace_back([&] { result = spb::pb::serialize(broadcast); });
+            }
+            for (const auto &result : results)
+                CHECK(result == protobuf);
+        }
+        SUBCASE("deserialize")
+        {
+            auto broadcast = spb::pb::deserialize<UnitTest::cached::Broadcast>(protobuf);
+            CHECK(broadcast.seq == 1);
+            CHECK(broadcast.config->value().name == "config");
+            CHECK(broadcast.config->value().values == config.values);
+            REQUIRE(broadcast.configs.size() == 1);
+            CHECK(broadcast.configs[0]->name == "config");
+            CHECK(spb::pb::serialize(broadcast) == protobuf);
+        }
+        SUBCASE("json")
+        {
+            const auto json      = spb::json::serialize(plain);
+            const auto broadcast = spb::json::deserialize<UnitTest::cached::Broadcast>(json);
+            CHECK(spb::json::serialize(broadcast) == json);
+            CHECK(spb::pb::serialize(broadcast) == protobuf);
+        }
+    }
+    SUBCASE("serialize_iov")
+    {
+        const auto person = PhoneBook::Person{
+            .name   = std::string(100, 'n'),
+            .id     = 123,
+            .email  = "john@example.com",
+            .phones = {{.number = std::string(64, '5'), .type = PhoneBook::Person::PhoneType::HOME}}};
+        const auto protobuf = spb::pb::serialize(person);
+
+        auto join = [](const spb::pb::iovec_builder &builder)
+        {
+            auto result = std::string();
+            for (const auto &chunk : builder.chunks)
+                result.append((const char *)chunk.data(), chunk.size());
+            return result;
+        };
+
+        auto builder = spb::pb::iovec_builder{.threshold = 32};
+        CHECK(spb::pb::serialize_iov(person, builder) == protobuf.size());
+        CHECK(join(builder) == protobuf);
+        CHECK(builder.scratch.size() == protobuf.size() - 100 - 64);
+        REQUIRE(builder.chunks.size() == 5);
+        CHECK((const void *)builder.chunks[1].data() == (const void *)person.name->data());
+        CHECK((const void *)builder.chunks[3].data() == (const void *)person.phones[0].number.data());
+
+        SUBCASE("delimited")
+        {
+            CHECK(spb::pb::serialize_iov(person, builder, {.delimited = true}) ==
+                  spb::pb::serialize_size(person, {.delimited = true}));
+            CHECK(join(builder) == spb::pb::serialize(person, {.delimited = true}));
+        }
+        SUBCASE("small")
+        {
+            builder.threshold = 1024;
+            CHECK(spb::pb::serialize_iov(person, builder) == protobuf.size());
+            REQUIRE(builder.chunks.size() == 1);
+            CHECK(join(builder) == protobuf);
+        }
+        SUBCASE("opt-in")
+        {
+            using spb::pb::detail::message_serializable;
+            using spb::pb::detail::ostream_iov;
+            static_assert(message_serializable<ostream_iov, PhoneBook::Person>);
+            static_assert(message_serializable<ostream_iov, PhoneBook::Person::PhoneNumber>);
+            static_assert(!message_serializable<ostream_iov, Test::Scalar::ReqString>);
+            static_assert(message_serializable<spb::pb::detail::ostream_buffer, Test::Scalar::ReqString>);
+        }
+    }
+    SUBCASE("segments")
+    {
+        const auto person = PhoneBook::Person{
+            .name   = "John Doe",
+            .id     = 1234567,
+            .email  = "QXUeh@example.com",
+            .phones = {{.number = "555-4321", .type = PhoneBook::Person::PhoneType::HOME},
+                       {.number = "555-1234", .type = PhoneBook::Person::PhoneType::WORK}}};
+        const auto protobuf = spb::pb::serialize<std::vector<std::byte>>(person);
+        const auto bytes    = std::span<const std::byte>(protobuf);
+
+        SUBCASE("split")
+        {
+            for (size_t i = 0; i <= bytes.size(); i++)
+            {
+                const auto segments = std::array{bytes.first(i), std::span<const std::byte>(), bytes.subspan(i)};
+                auto deserialized   = PhoneBook::Person();
+                CHECK(spb::pb::deserialize(deserialized, segments) == bytes.size());
+                CHECK(deserialized == person);
+            }
+        }
+        SUBCASE("bytes")
+        {
+            auto segments = std::vector<std::span<const std::byte>>();
+            for (size_t i = 0; i < bytes.size(); i++)
+                segments.push_back(bytes.subspan(i, 1));
+
+            CHECK(spb::pb::deserialize<PhoneBook::Person>(segments) == person);
+        }
+        SUBCASE("delimited")
+        {
+            const auto delimited = spb::pb::serialize<std::vector<std::byte>>(person, {.delimited = true});
+            const auto segments  = std::array{std::span<const std::byte>(delimited).first(1),
+                                              std::span<const std::byte>(delimited).subspan(1)};
+            CHECK(spb::pb::deserialize<PhoneBook::Person>(segments, {.delimited = true}) == person);
+        }
+        SUBCASE("invalid")
+        {
+            const auto segments = std::array{bytes.first(5), bytes.subspan(5, 10)};
+            CHECK_THROWS((void)spb::pb::deserialize<PhoneBook::Person>(segments));
+        }
+    }
+    SUBCASE("builder")
+    {
+        using namespace UnitTest::builder;
+
+        auto protobuf = std::string();
+        auto writer   = [&protobuf](const void *p_data, size_t size)
+        { protobuf.append(static_cast<const char *>(p_data), size); };
+
+        const auto phone = Phone{.number = "555-4321", .type = 2};
+
+        SUBCASE("fields")
+        {
+            auto builder = spb::pb::builder<Person>(writer);
+            builder.set_name("John");
+            builder.set_id(42);
+            builder.add_phones(phone);
+            builder.add_attrs("age", 33);
+            builder.set_email("john@example.com");
+            CHECK(builder.size() == protobuf.size());
+
+            const auto person = Person{.name    = "John",
+                                       .id      = 42,
+                                       .phones  = {phone},
+                                       .attrs   = {{"age", 33}},
+                                       .contact = decltype(Person::contact){std::in_place_index<1>,
+                                                                            "john@example.com"}};
+            CHECK(protobuf == spb::pb::serialize(person));
+        }
+        SUBCASE("packed")
+        {
+            auto builder = spb::pb::builder<Person>(writer);
+            for (int i = -2; i <= 2; i++)
+                builder.add_scores(i);
+
+            CHECK(spb::pb::deserialize<Person>(protobuf).scores == std::vector<int32_t>{-2, -1, 0, 1, 2});
+        }
+        SUBCASE("nested")
+        {
+            auto book = Book{};
+            for (int i = 0; i < 3; i++)
+                book.people.push_back(Person{.name = std::string(i + 1, 'x'), .phones = {phone, phone}});
+            book.owner = book.people[0];
+
+            auto builder = spb::pb::builder<Book>(writer);
+            for (const auto &person : book.people)
+            {
+                auto child = builder.begin_people();
+                child.set_name(*person.name);
+                for (const auto &p : person.phones)
+                {
+                    auto grandchild = child.begin_phones();
+                    grandchild.set_number(*p.number);
+                    grandchild.set_type(*p.type);
+                    grandchild.end();
+                }
+                child.end();
+            }
+            auto owner = builder.begin_owner(spb::pb::serialize_size(*book.owner));
+            owner.set_name(*book.owner->name);
+            owner.add_phones(phone);
+            owner.add_phones(phone);
+            owner.end();
+
+            CHECK(protobuf == spb::pb::serialize(book));
+        }
+        SUBCASE("invalid size")
+        {
+            auto builder = spb::pb::builder<Book>(writer);
+            auto owner   = builder.begin_owner(3);
+            CHECK_THROWS(owner.set_name("John"));
+            CHECK_THROWS(owner.end());
+
+            auto person = builder.begin_people(10);
+            person.set_name("John");
+            CHECK_THROWS(person.end());
+        }
+        SUBCASE("temporary writer")
+        {
+            auto builder = spb::pb::builder<Person>(
+                [&protobuf](const void *p_data, size_t size)
+                { protobuf.append(static_cast<const char *>(p_data), size); });
+            builder.set_name("John");
+            CHECK(protobuf == spb::pb::serialize(Person{.name = "John"}));
+        }
+        SUBCASE("one open sub-message")
+        {
+            const auto person = Person{.name = "John", .phones = {phone}};
+
+            auto builder = spb::pb::builder<Book>(writer);
+            auto child   = builder.begin_people();
+            CHECK_THROWS((void)builder.begin_people());
+            CHECK_THROWS((void)builder.begin_owner(3));
+            CHECK_THROWS(builder.add_people(person));
+            child.set_name("John");
+
+            auto grandchild = child.begin_phones(spb::pb::serialize_size(phone));
+            CHECK_THROWS(child.set_name("John"));
+            CHECK_THROWS(child.end());
+            grandchild.set_number(*phone.number);
+            grandchild.set_type(*phone.type);
+            grandchild.end();
+            child.end();
+
+            builder.add_people(person);
+            CHECK(protobuf == spb::pb::serialize(Book{.people = {person, person}}));
+        }
+    }
+    SUBCASE("streaming")
+    {
+        const auto person = PhoneBook::Person{
+            .name   = "John Doe",
+            .id     = 1234567,
+            .email  = "QXUeh@example.com",
+            .phones = {{.number = "555-4321", .type = PhoneBook::Person::PhoneType::HOME},
+                       {.number = "555-1234", .type = PhoneBook::Person::PhoneType::WORK}}};
+        const auto protobuf = spb::pb::serialize(person);
+
+        auto phones  = std::vector<PhoneBook::Person::PhoneNumber>();
+        auto handler = [&phones](PhoneBook::Person::PhoneNumber &&phone)
+        { phones.push_back(std::move(phone)); };
+
+        SUBCASE("buffer")
+        {
+            const auto streamed = spb::pb::deserialize_streaming<PhoneBook::Person>(
+                protobuf, spb::on_element(&PhoneBook::Person::phones, handler));
+            CHECK(streamed.name == person.name);
+            CHECK(streamed.email == person.email);
+            CHECK(streamed.phones.empty());
+            CHECK(phones == person.phones);
+        }
+        SUBCASE("reader")
+        {
+            auto input  = std::string_view(protobuf);
+            auto reader = [&input](void *p_data, size_t size) -> size_t
+            {
+                const auto chunk = std::min(size, input.size());
+                memcpy(p_data, input.data(), chunk);
+                input.remove_prefix(chunk);
+                return chunk;
+            };
+            const auto streamed = spb::pb::deserialize_streaming<PhoneBook::Person>(
+                reader, spb::on_element(&PhoneBook::Person::phones, handler));
+            CHECK(streamed.id == person.id);
+            CHECK(streamed.phones.empty());
+            CHECK(phones == person.phones);
+        }
+        SUBCASE("packed")
+        {
+            const auto packed   = spb::pb::serialize(UnitTest::builder::Person{.scores = {1, -2, 3}});
+            auto scores         = std::vector<int32_t>();
+            auto handler_scores = [&scores](int32_t v) { scores.push_back(v); };
+            const auto streamed = spb::pb::deserialize_streaming<UnitTest::builder::Person>(
+                packed, spb::on_element(&UnitTest::builder::Person::scores, handler_scores));
+            CHECK(streamed.scores.empty());
+            CHECK(scores == std::vector<int32_t>{1, -2, 3});
+
+            //- elements are passed on before the rest of the record is read
+            auto input  = std::string_view(packed);
+            auto left   = std::vector<size_t>();
+            auto reader = [&input](void *p_data, size_t size) -> size_t
+            {
+                const auto chunk = std::min(size, input.size());
+                memcpy(p_data, input.data(), chunk);
+                input.remove_prefix(chunk);
+                return chunk;
+            };
+            auto handler_left = [&](int32_t) { left.push_back(input.size()); };
+            (void) spb::pb::deserialize_streaming<UnitTest::builder::Person>(
+                reader, spb::on_element(&UnitTest::builder::Person::scores, handler_left));
+            REQUIRE(left.size() == 3);
+            CHECK(left[0] > left[1]);
+            CHECK(left[1] > left[2]);
+        }
+    }
+    SUBCASE("stream bytes")
+    {
+        using namespace UnitTest::stream;
+
+        auto payload = std::vector<std::byte>(10000);
+        for (size_t i = 0; i < payload.size(); i++)
+            payload[i] = std::byte(i * 7);
+
+        const auto plain = Plain{.name = "file", .data = payload, .crc = 42};
+        auto offset      = size_t(0);
+        auto source      = [&](std::span<std::byte> buffer) -> size_t
+        {
+            //- provide less than requested to exercise the refill loop
+            const auto size = std::min({buffer.size(), payload.size() - offset, size_t(1000)});
+            memcpy(buffer.data(), payload.data() + offset, size);
+            offset += size;
+            return size;
+        };
+
+        auto upload = Upload{.name = "file", .crc = 42};
+        upload.data.set_source(payload.size(), source);
+        const auto protobuf = spb::pb::serialize(upload);
+        CHECK(protobuf == spb::pb::serialize(plain));
+
+        SUBCASE("deserialize")
+        {
+            auto received = std::vector<std::byte>();
+            auto chunks   = size_t(0);
+            auto decoded  = Upload{};
+            decoded.data.set_sink(
+                [&](std::span<const std::byte> chunk)
+                {
+                    received.insert(received.end(), chunk.begin(), chunk.end());
+                    chunks++;
+                });
+            spb::pb::deserialize(decoded, protobuf);
+            CHECK(decoded.name == "file");
+            CHECK(decoded.crc == 42);
+            CHECK(decoded.data.size() == payload.size());
+            CHECK(received == payload);
+            CHECK(chunks > 1);
+        }
+        SUBCASE("nested")
+        {
+            offset        = 0;
+            auto envelope = Envelope{.upload = Upload{.name = "file", .crc = 42}};
+            envelope.upload->data.set_source(payload.size(), source);
+            const auto nested = spb::pb::serialize(envelope);
+            CHECK(offset == payload.size());
+            CHECK(nested.size() == spb::pb::serialize_size(envelope));
+            CHECK(nested.ends_with(protobuf));
+        }
+        SUBCASE("short source")
+        {
+            offset = 0;
+            upload.data.set_source(payload.size() + 1, source);
+            CHECK_THROWS((void)spb::pb::serialize(upload));
+        }
+        SUBCASE("no sink")
+        {
+            CHECK_THROWS((void)spb::pb::deserialize<Upload>(protobuf));
+        }
+        SUBCASE("json")
+        {
+            offset = 0;
+            CHECK(spb::json::serialize(upload) == spb::json::serialize(plain));
+
+            auto received = std::vector<std::byte>();
+            auto chunks   = size_t(0);
+            auto decoded  = Upload{};
+            decoded.data.set_sink(
+                [&](std::span<const std::byte> chunk)
+                {
+                    CHECK(chunk.size() <= 3 * 1024);
+                    received.insert(received.end(), chunk.begin(), chunk.end());
+                    chunks++;
+                });
+            const auto json = spb::json::serialize(plain);
+            spb::json::deserialize(decoded, json);
+            CHECK(received == payload);
+            CHECK(chunks > 1);
+
+            //- base64 split between reader refills
+            auto input  = std::string_view(json);
+            auto reader = [&input](void *p_data, size_t size) -> size_t
+            {
+                const auto chunk = std::min({size, input.size(), size_t(7)});
+                memcpy(p_data, input.data(), chunk);
+                input.remove_prefix(chunk);
+                return chunk;
+            };
+            received.clear();
+            spb::json::deserialize(decoded, reader);
+            CHECK(received == payload);
+
+            for (const auto *invalid : {R"({"data":"AAA"})", R"({"data":"AA=A"})", R"({"data":"AA==AAAA"})",
+                                        R"({"data":"A*AA"})", R"({"data":"AAAA)"})
+                CHECK_THROWS(spb::json::deserialize(decoded, std::string_view(invalid)));
+
+            received.clear();
+            spb::json::deserialize(decoded, R"({"data":"AQI="})"sv);
+            CHECK(received == std::vector<std::byte>{std::byte(1), std::byte(2)});
+        }
+    }
+    SUBCASE("string view")
+    {
+        using namespace UnitTest::view;
+
+        const auto json = std::string(R"({ "name" : "John", "tags" : ["a", "b\"c"], "id" : 1, "nick":"J" })");
+        const auto protobuf = spb::pb::serialize(spb::json::deserialize<Owned>(json));
+        const auto owned    = spb::pb::deserialize<Owned>(protobuf);
+        CHECK(*owned.name == "John");
+        CHECK(owned.name->data() >= protobuf.data());
+        CHECK(owned.name->data() < protobuf.data() + protobuf.size());
+        CHECK(owned.tags[1] == "b\"c");
+        CHECK(spb::pb::serialize(owned) == protobuf);
+
+        const auto borrowed = spb::pb::deserialize<Borrowed>(protobuf);
+        CHECK(borrowed.tags == std::vector<std::string_view>{"a", "b\"c"});
+        CHECK_NOTHROW(spb::pb::validate<Borrowed>(protobuf));
+        CHECK_THROWS((void)spb::pb::deserialize<Borrowed>("\x0a\x02h\x80"sv));
+
+        //- a chain has no contiguous input, so the strings are copied (and std::string_view is rejected)
+        const auto bytes    = std::as_bytes(std::span(protobuf));
+        const auto segments = std::array{bytes.first(3), bytes.subspan(3)};
+        const auto chained  = spb::pb::deserialize<Owned>(segments);
+        CHECK(*chained.name == "John");
+        CHECK(!chained.name->is_borrowed());
+        CHECK(spb::pb::serialize(chained) == protobuf);
+        static_assert(!spb::pb::detail::message_deserializable<spb::pb::detail::istream_chain, Borrowed>);
+        static_assert(!spb::pb::detail::message_deserializable<spb::pb::detail::istream_reader, Borrowed>);
+        static_assert(spb::pb::detail::message_deserializable<spb::pb::detail::istream_reader, Owned>);
+        static_assert(spb::pb::detail::message_deserializable<spb::pb::detail::istream_buffer, Borrowed>);
+        //- chain is opt-in
+        using Test::Scalar::ReqString;
+        static_assert(!spb::pb::detail::message_deserializable<spb::pb::detail::istream_chain, ReqString>);
+        static_assert(!spb::pb::detail::message_deserializable<spb::pb::detail::istream_reader, Holder>);
+    }
+    SUBCASE("field mask")
+    {
+        const auto person = PhoneBook::Person{
+            .name   = "John Doe",
+            .id     = 1234567,
+            .email  = "QXUeh@example.com",
+            .phones = {{.number = "555-4321", .type = PhoneBook::Person::PhoneType::HOME},
+                       {.number = "555-1234", .type = PhoneBook::Person::PhoneType::WORK}}};
+        const auto protobuf = spb::pb::serialize<std::vector<std::byte>>(person);
+
+        SUBCASE("fields")
+        {
+            const auto masked = spb::pb::deserialize<PhoneBook::Person, spb::fields<1, 4>>(protobuf);
+            CHECK(masked.name == person.name);
+            CHECK(!masked.id.has_value());
+            CHECK(!masked.email.has_value());
+            CHECK(masked.phones == person.phones);
+        }
+        SUBCASE("none")
+        {
+            CHECK(spb::pb::deserialize<PhoneBook::Person, spb::fields<>>(protobuf) == PhoneBook::Person{});
+        }
+        SUBCASE("nested")
+        {
+            const auto mask   = spb::field_mask{{2}, {4, 1}};
+            const auto masked = spb::pb::deserialize<PhoneBook::Person>(protobuf, {.mask = &mask});
+            CHECK(!masked.name.has_value());
+            CHECK(masked.id == person.id);
+            REQUIRE(masked.phones.size() == 2);
+            CHECK(masked.phones[0].number == "555-4321");
+            CHECK(!masked.phones[0].type.has_value());
+            CHECK(masked.phones[1].number == "555-1234");
+            CHECK(!masked.phones[1].type.has_value());
+        }
+        SUBCASE("reader")
+        {
+            auto offset = size_t(0);
+            auto reader = [&](void *p_data, size_t size) -> size_t
+            {
+                size = std::min(size, protobuf.size() - offset);
+                memcpy(p_data, protobuf.data() + offset, size);
+                offset += size;
+                return size;
+            };
+            const auto masked = spb::pb::deserialize<PhoneBook::Person, spb::fields<3>>(reader);
+            CHECK(masked == PhoneBook::Person{.email = person.email});
+        }
+        SUBCASE("segments")
+        {
+            const auto mask     = spb::field_mask{{4, 2}};
+            const auto bytes    = std::span<const std::byte>(protobuf);
+            const auto segments = std::array{bytes.first(7), bytes.subspan(7)};
+            auto masked         = PhoneBook::Person{};
+            CHECK(spb::pb::deserialize(masked, segments, {.mask = &mask}) == bytes.size());
+            REQUIRE(masked.phones.size() == 2);
+            CHECK(masked.phones[0].number.empty());
+            CHECK(masked.phones[1].type == PhoneBook::Person::PhoneType::WORK);
+        }
+        SUBCASE("delimited")
+        {
+            const auto mask      = spb::field_mask{{1}};
+            const auto delimited = spb::pb::serialize<std::vector<std::byte>>(person, {.delimited = true});
+            const auto masked =
+                spb::pb::deserialize<PhoneBook::Person>(delimited, {.delimited = true, .mask = &mask});
+            CHECK(masked == PhoneBook::Person{.name = person.name});
+        }
+    }
+    SUBCASE("serialize field mask")
+    {
+        const auto person = PhoneBook::Person{
+            .name   = "John Doe",
+            .id     = 1234567,
+            .email  = "QXUeh@example.com",
+            .phones = {{.number = "555-4321", .type = PhoneBook::Person::PhoneType::HOME},
+                       {.number = "555-1234", .type = PhoneBook::Person::PhoneType::WORK}}};
+
+        SUBCASE("fields")
+        {
+            const auto trimmed = PhoneBook::Person{.name = person.name, .phones = person.phones};
+            CHECK(spb::pb::serialize<spb::fields<1, 4>>(person) == spb::pb::serialize(trimmed));
+            CHECK(spb::pb::serialize<spb::fields<>>(person).empty());
+        }
+        SUBCASE("nested")
+        {
+            const auto mask    = spb::field_mask{{2}, {4, 1}};
+            const auto trimmed = PhoneBook::Person{
+                .id = person.id, .phones = {{.number = "555-4321"}, {.number = "555-1234"}}};
+            const auto expected = spb::pb::serialize(trimmed);
+
+            CHECK(spb::pb::serialize(person, {.mask = &mask}) == expected);
+            CHECK(spb::pb::serialize_size(person, {.mask = &mask}) == expected.size());
+            CHECK(spb::pb::serialize(person, {.delimited = true, .mask = &mask}) ==
+                  spb::pb::serialize(trimmed, {.delimited = true}));
+
+            auto written = std::string();
+            CHECK(spb::pb::serialize(
+                      person, [&](const void *p_data, size_t size)
+                      { written.append(static_cast<const char *>(p_data), size); }, {.mask = &mask}) ==
+                  expected.size());
+            CHECK(written == expected);
+
+            auto builder = spb::pb::iovec_builder{};
+            CHECK(spb::pb::serialize_iov(person, builder, {.mask = &mask}) == expected.size());
+            auto joined = std::string();
+            for (auto chunk : builder.chunks)
+                joined.append((const char *)chunk.data(), chunk.size());
+            CHECK(joined == expected);
+        }
+        SUBCASE("cached and raw")
+        {
+            using UnitTest::cached::Broadcast;
+            using UnitTest::cached::BroadcastPlain;
+            using UnitTest::cached::Config;
+
+            //- a sub-path mask can't use the pre-encoded bytes, they have all fields of the sub-message
+            const auto config    = Config{.name = "config", .values = {1, 2, 3}};
+            const auto broadcast = Broadcast{.seq = 1, .config = config, .configs = {config, config}};
+            const auto mask      = spb::field_mask{{2, 1}, {3, 2}};
+            const auto expected  = spb::pb::serialize(BroadcastPlain{
+                 .config = Config{.name = "config"}, .configs = {{.values = {1, 2, 3}}, {.values = {1, 2, 3}}}});
+            CHECK(spb::pb::serialize(broadcast, {.mask = &mask}) == expected);
+            CHECK(spb::pb::serialize_size(broadcast, {.mask = &mask}) == expected.size());
+
+            const auto whole = spb::field_mask{{2}};
+            CHECK(spb::pb::serialize(broadcast, {.mask = &whole}) ==
+                  spb::pb::serialize(BroadcastPlain{.config = config}));
+
+            const auto payload  = UnitTest::raw::Payload{.name = "payload", .id = 7};
+            const auto envelope = UnitTest::raw::Envelope{.seq   = 1,
+                                                          .payload = spb::pb::raw<UnitTest::raw::Payload>(payload),
+                                                          .items   = {spb::pb::raw<UnitTest::raw::Payload>(payload)}};
+            const auto raw_mask = spb::field_mask{{2, 2}, {3, 1}};
+            CHECK(spb::pb::serialize(envelope, {.mask = &raw_mask}) ==
+                  spb::pb::serialize(UnitTest::raw::EnvelopeDecoded{.payload = UnitTest::raw::Payload{.id = 7},
+                                                                    .items   = {{.name = "payload"}}}));
+
+            //- the masked payload is decoded into a temporary, its large string can't be referenced
+            const auto large      = UnitTest::raw::Payload{.name = std::string(1000, 'p'), .id = 7};
+            const auto large_raw  = UnitTest::raw::Envelope{.payload = spb::pb::raw(large)};
+            const auto large_mask = spb::field_mask{{2, 1}};
+            const auto large_expected = spb::pb::serialize(
+                UnitTest::raw::EnvelopeDecoded{.payload = UnitTest::raw::Payload{.name = large.name}});
+            auto builder = spb::pb::iovec_builder{.threshold = 32};
+            CHECK(spb::pb::serialize_iov(large_raw, builder, {.mask = &large_mask}) == large_expected.size());
+            CHECK(builder.scratch.size() == large_expected.size());
+            auto joined = std::string();
+            for (auto chunk : builder.chunks)
+                joined.append((const char *)chunk.data(), chunk.size());
+            CHECK(joined == large_expected);
+        }
+        SUBCASE("empty sub-message")
+        {
+            const auto mask = spb::field_mask{{1}, {4, 3}};
+            CHECK(spb::pb::serialize(person, {.mask = &mask}) ==
+                  spb::pb::serialize(PhoneBook::Person{.name = person.name}));
+        }
+    }
+    SUBCASE("validate")
+    {
+        using namespace UnitTest::validate;
+
+        auto order = Order{.number  = 42,
+                           .level   = Level::HIGH,
+                           .note    = "note",
+                           .items   = {{.id = 1, .label = "a"}, {.id = 2}},
+                           .codes   = {1, 2, 3},
+                           .blob    = std::vector{std::byte(1), std::byte(2)},
+                           .flags   = 5,
+                           .attrs   = {{"k", Level::LOW}},
+                           .contact = Item{.id = 3}};
+
+        SUBCASE("valid")
+        {
+            CHECK_NOTHROW(spb::pb::validate<Order>(spb::pb::serialize(order)));
+            CHECK_NOTHROW(spb::pb::validate<Order>(spb::pb::serialize(Order{})));
+            //- unknown fields are skipped
+            const auto unknown = "\x28\x01\x32\x01\xff"s;
+            CHECK_NOTHROW(spb::pb::validate<Item>(spb::pb::serialize(Item{.id = 1}) + unknown));
+        }
+        SUBCASE("required")
+        {
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(Item{.id = 1})));
+            CHECK_THROWS(spb::pb::validate<Item>(""sv));
+            order.items[1].id = 0;
+            CHECK_NOTHROW(spb::pb::validate<Order>(spb::pb::serialize(order)));
+        }
+        SUBCASE("max size")
+        {
+            order.note = "123456789";
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(order)));
+            order.note = "12345678";
+            order.blob = std::vector<std::byte>(5);
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(order)));
+            order.blob->pop_back();
+            order.items[0].label = "123456789";
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(order)));
+        }
+        SUBCASE("max count")
+        {
+            order.codes.push_back(4);
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(order)));
+            order.codes.pop_back();
+            order.items.push_back({.id = 3});
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(order)));
+        }
+        SUBCASE("utf8")
+        {
+            order.note = "\xc3\x28";
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(order)));
+            order.note    = "a";
+            order.contact = "\xff";
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(order)));
+        }
+        SUBCASE("enum")
+        {
+            order.level = Level(7);
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(order)));
+            order.level = Level::LOW;
+            order.attrs = {{"k", Level(2)}};
+            CHECK_THROWS(spb::pb::validate<Order>(spb::pb::serialize(order)));
+
+            //- proto3 enums are open, unknown values are valid (and deserialized)
+            const auto open = spb::pb::serialize(example::SomeMessage{.values = {example::SomeEnum(7)}});
+            CHECK_NOTHROW(spb::pb::validate<example::SomeMessage>(open));
+            CHECK(spb::pb::deserialize<example::SomeMessage>(open).values ==
+                  std::vector{example::SomeEnum(7)});
+            CHECK_THROWS(spb::pb::validate<example::SomeMessage>("\x0a\x01\x80"sv));
+        }
+        SUBCASE("wire")
+        {
+            const auto valid = spb::pb::serialize(Item{.id = 1});
+            CHECK_THROWS(spb::pb::validate<Item>(valid + "\x00"s));
+            CHECK_THROWS(spb::pb::validate<Item>(valid.substr(0, 1)));
+            //- id as fixed32
+            CHECK_THROWS(spb::pb::validate<Item>("\x0d\x01\x00\x00\x00"sv));
+            //- label as varint
+            CHECK_THROWS(spb::pb::validate<Item>(valid + "\x10\x01"s));
+            //- label longer than the message
+            CHECK_THROWS(spb::pb::validate<Item>(valid + "\x12\x05"s + "ab"));
+            //- flags do not fit in 3 bits
+            CHECK_THROWS(spb::pb::validate<Order>("\x08\x01\x10\x01\x40\x08"sv));
+            CHECK_NOTHROW(spb::pb::validate<Order>("\x08\x01\x10\x01\x40\x07"sv));
+        }
+    }
+    SUBCASE("trusted")
+    {
+        const auto person = PhoneBook::Person{
+            .name   = "John Doe",
+            .id     = 1234567,
+            .email  = "QXUeh@example.com",
+            .phones = {{.number = "555-4321", .type = PhoneBook::Person::PhoneType::HOME},
+                       {.number = "555-1234", .type = PhoneBook::Person::PhoneType::WORK}}};
+
+        SUBCASE("round trip")
+        {
+            CHECK(spb::pb::deserialize<PhoneBook::Person>(spb::pb::serialize(person), {.trusted = true}) ==
+                  person);
+            const auto delimited = spb::pb::serialize(person, {.delimited = true});
+            CHECK(spb::pb::deserialize<PhoneBook::Person>(delimited, {.delimited = true, .trusted = true}) ==
+                  person);
+        }
+        SUBCASE("checks are skipped")
+        {
+            const auto trusted = spb::pb::deserialize_options{.trusted = true};
+
+            CHECK_THROWS((void)spb::pb::deserialize<Test::Scalar::ReqString>("\x0a\x02h\x80"sv));
+            CHECK(spb::pb::deserialize<Test::Scalar::ReqString>("\x0a\x02h\x80"sv, trusted).value == "h\x80");
+            CHECK_THROWS((void)spb::pb::deserialize<Test::Scalar::ReqBool>("\x08\x02"sv));
+            CHECK(spb::pb::deserialize<Test::Scalar::ReqBool>("\x08\x02"sv, trusted).value);
+            CHECK_THROWS((void)spb::pb::deserialize<Test::Scalar::ReqUint8>("\x08\x80\x02"sv));
+            CHECK(spb::pb::deserialize<Test::Scalar::ReqUint8>("\x08\x80\x02"sv, trusted).value == 0);
+            CHECK_THROWS((void)spb::pb::deserialize<Test::Scalar::ReqFixed32_8>("\x0d\x00\x01\x00\x00"sv));
+            CHECK(spb::pb::deserialize<Test::Scalar::ReqFixed32_8>("\x0d\x00\x01\x00\x00"sv, trusted).value ==
+                  0);
+        }
+        SUBCASE("bounds are checked")
+        {
+            const auto trusted = spb::pb::deserialize_options{.trusted = true};
+
+            CHECK_THROWS((void)spb::pb::deserialize<Test::Scalar::ReqString>("\x0a\x05hell"sv, trusted));
+            CHECK_THROWS((void)spb::pb::deserialize<Test::Scalar::ReqInt32>("\x08\xff"sv, trusted));
+            CHECK_THROWS((void)spb::pb::deserialize<Test::Scalar::ReqFixed32_8>("\x0d\x00\x01"sv, trusted));
+        }
+        SUBCASE("opt-in")
+        {
+            //- messages without (spb_msgopt).trusted are deserialized with all checks
+            const auto trusted = spb::pb::deserialize_options{.trusted = true};
+
+            CHECK_THROWS((void)spb::pb::deserialize<UnitTest::raw::Payload>("\x0a\x02h\x80"sv, trusted));
+            CHECK(spb::pb::deserialize<UnitTest::raw::Payload>("\x0a\x02hi"sv, trusted).name == "hi");
+        }
+    }
+    SUBCASE("budget")
+    {
+        const auto person = PhoneBook::Person{
+            .name   = "John Doe",
+            .id     = 1234567,
+            .email  = "QXUeh@example.com",
+            .phones = {{.number = "555-4321", .type = PhoneBook::Person::PhoneType::HOME},
+                       {.number = "555-1234", .type = PhoneBook::Person::PhoneType::WORK}}};
+        const auto protobuf = spb::pb::serialize(person);
+
+        SUBCASE("elements")
+        {
+            CHECK(spb::pb::deserialize<PhoneBook::Person>(protobuf, {.max_total_elements = 2}) == person);
+            CHECK_THROWS_AS(
+                (void)spb::pb::deserialize<PhoneBook::Person>(protobuf, {.max_total_elements = 1}),
+                std::length_error);
+
+            const auto order =
+                UnitTest::validate::Order{.attrs = {{"a", UnitTest::validate::Level::LOW},
+                                                    {"b", UnitTest::validate::Level::HIGH}}};
+            CHECK_NOTHROW((void)spb::pb::deserialize<UnitTest::validate::Order>(spb::pb::serialize(order),
+                                                                                {.max_total_elements = 2}));
+            CHECK_THROWS((void)spb::pb::deserialize<UnitTest::validate::Order>(spb::pb::serialize(order),
+                                                                               {.max_total_elements = 1}));
+        }
+        SUBCASE("bytes")
+        {
+            CHECK(spb::pb::deserialize<PhoneBook::Person>(protobuf, {.max_allocated_bytes = 4096}) == person);
+            CHECK_THROWS_AS(
+                (void)spb::pb::deserialize<PhoneBook::Person>(protobuf, {.max_allocated_bytes = 16}),
+                std::length_error);
+        }
+        SUBCASE("amplification")
+        {
+            //- every 2 bytes of input allocate a whole PhoneNumber
+            auto empty_phones = std::string();
+            for (auto i = 0; i < 1000; i++)
+                empty_phones += "\x22\x00"sv;
+
+            CHECK(spb::pb::deserialize<PhoneBook::Person>(empty_phones).phones.size() == 1000);
+            CHECK_THROWS_AS(
+                (void)spb::pb::deserialize<PhoneBook::Person>(empty_phones, {.max_allocated_bytes = 4096}),
+                std::length_error);
+        }
+        SUBCASE("segments")
+        {
+            const auto bytes    = std::as_bytes(std::span(protobuf));
+            const auto segments = std::array{bytes.first(5), bytes.subspan(5)};
+            CHECK(spb::pb::deserialize<PhoneBook::Person>(segments, {.max_total_elements = 2}) == person);
+            CHECK_THROWS((void)spb::pb::deserialize<PhoneBook::Person>(segments, {.max_total_elements = 1}));
+        }
+    }
 }